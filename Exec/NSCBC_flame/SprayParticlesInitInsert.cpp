@@ -42,6 +42,8 @@ SprayParticleContainer::insertParticles(Real time, int nstep, int lev)
         ParticleType p;
         p.id() = ParticleType::NextID();
         p.cpu() = ParallelDescriptor::MyProc();
+        p.idata(SPRAY_KEY_COMP) =
+          sprayParticleKey(p.id(), p.cpu(), 0., spray_key_case);
 
         p.pos(0) = x;
         p.pos(1) = y;
@@ -111,6 +113,8 @@ SprayParticleContainer::injectParticles(Real time, int nstep, int lev)
         ParticleType p;
         p.id() = ParticleType::NextID();
         p.cpu() = ParallelDescriptor::MyProc();
+        p.idata(SPRAY_KEY_COMP) =
+          sprayParticleKey(p.id(), p.cpu(), 0., spray_key_case);
 
         p.pos(0) = x;
         p.pos(1) = y;
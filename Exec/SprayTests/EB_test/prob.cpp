@@ -23,8 +23,6 @@ amrex_probinit(
   pp.query("init_O2", PeleC::h_prob_parm_device->Y_O2);
   pp.query("jet_vel", PeleC::prob_parm_host->jet_vel);
   pp.get("jet_dia", PeleC::prob_parm_host->jet_dia);
-  // The cells are divided by this value when prescribing the jet inlet
-  pp.query("jet_dx_mod", PeleC::prob_parm_host->jet_dx_mod);
   pp.get("part_mean_dia", PeleC::prob_parm_host->part_mean_dia);
   pp.query("part_stdev_dia", PeleC::prob_parm_host->part_stdev_dia);
   pp.get("part_temp", PeleC::prob_parm_host->part_temp);
@@ -20,8 +20,6 @@ amrex_probinit(
   pp.query("jet_vel", PeleLM::prob_parm->jet_vel);
   pp.query("jet_start_time", PeleLM::prob_parm->jet_start_time);
   pp.query("jet_end_time", PeleLM::prob_parm->jet_end_time);
-  // The cells are divided by this value when prescribing the jet inlet
-  pp.query("jet_dx_mod", PeleLM::prob_parm->jet_dx_mod);
   pp.get("jet_dia", PeleLM::prob_parm->jet_dia);
   pp.get("part_mean_dia", PeleLM::prob_parm->part_mean_dia);
   pp.query("part_stdev_dia", PeleLM::prob_parm->part_stdev_dia);
@@ -18,7 +18,6 @@ amrex_probinit(
   pp.query("init_N2", PeleLM::prob_parm->Y_N2);
   pp.query("init_O2", PeleLM::prob_parm->Y_O2);
   // Find the number of redistributions during particle initialization
-  pp.query("init_redist", PeleLM::prob_parm->numRedist);
   pp.query("num_particles", PeleLM::prob_parm->partNum);
   std::array<amrex::Real, AMREX_SPACEDIM> pvel;
   pp.query<amrex::Real>("part_vel", pvel);
@@ -21,4 +21,7 @@ void
 SprayParticleContainer::InitSprayParticles(
   ProbParmHost const& prob_parm, ProbParmDevice const& prob_parm_d)
 {
+  // Read the initial particles from a binary file if one is provided
+  if (!m_initBinaryFile.empty())
+    readSprayBinaryFile(m_initBinaryFile);
 }
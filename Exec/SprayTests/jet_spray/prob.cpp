@@ -37,12 +37,31 @@ read_inject(const std::string myfile)
   std::getline(iss, firstline);
   int pos1 = 0;
   int pos2 = 0;
+  // The first data line decides if the optional column with the mean
+  // droplet diameter is present, every line must then match it
+  bool has_dia = false;
+  PeleC::prob_parm_host->inject_dia.clear();
   for (int i = 0; i < PeleC::prob_parm_host->inject_N; i++) {
     std::getline(iss, remaininglines);
     std::istringstream sinput(remaininglines);
     sinput >> PeleC::prob_parm_host->inject_time[i];
     sinput >> PeleC::prob_parm_host->inject_mass[i];
     sinput >> PeleC::prob_parm_host->inject_vel[i];
+    amrex::Real inj_dia;
+    const bool line_dia = static_cast<bool>(sinput >> inj_dia);
+    if (i == 0) {
+      has_dia = line_dia;
+      if (has_dia)
+        PeleC::prob_parm_host->inject_dia.resize(
+          PeleC::prob_parm_host->inject_N);
+    } else if (line_dia != has_dia) {
+      amrex::Abort(
+        "Line " + std::to_string(i + 2) +
+        " of inject file does not match the diameter column of the first "
+        "data line");
+    }
+    if (has_dia)
+      PeleC::prob_parm_host->inject_dia[i] = inj_dia;
   }
 
   PeleC::prob_parm_host->jet_start_time = PeleC::prob_parm_host->inject_time[0];
@@ -68,8 +87,6 @@ amrex_probinit(
   pp.query("init_N2", PeleC::h_prob_parm_device->Y_N2);
   pp.query("init_O2", PeleC::h_prob_parm_device->Y_O2);
   pp.query("jet_vel", PeleC::prob_parm_host->jet_vel);
-  // The cells are divided by this value when prescribing the jet inlet
-  pp.query("jet_dx_mod", PeleC::prob_parm_host->jet_dx_mod);
   pp.get("jet_dia", PeleC::prob_parm_host->jet_dia);
   pp.get("part_mean_dia", PeleC::prob_parm_host->part_mean_dia);
   pp.query("part_stdev_dia", PeleC::prob_parm_host->part_stdev_dia);
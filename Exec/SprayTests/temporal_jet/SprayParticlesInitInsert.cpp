@@ -80,6 +80,7 @@ SprayParticleContainer::InitSprayParticles(
     ParticleType p;
     p.id() = ParticleType::NextID();
     p.cpu() = ParallelDescriptor::MyProc();
+    p.idata(SPRAY_KEY_COMP) = sprayParticleKey(prc, 0, 0., spray_key_case);
     AMREX_D_TERM(p.pos(0) = jet_loc[0] + (amrex::Random() - 0.5) * jet_len;
                  , p.pos(1) = start_loc + amrex::Random() * cur_len_pp;
                  , p.pos(2) = jet_loc[2] + (amrex::Random() - 0.5) * jet_len;);
@@ -0,0 +1,634 @@
+#include "SprayParticles.H"
+#include "SprayBinaryIO.H"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <map>
+
+using namespace amrex;
+
+namespace {
+template <typename T>
+void
+readValue(std::istream& is, T& val)
+{
+  is.read(reinterpret_cast<char*>(&val), sizeof(T));
+}
+
+template <typename T>
+void
+writeValue(std::ostream& os, const T val)
+{
+  os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+constexpr int magic_len = 8;
+
+// Write the encoded columns of one chunk into a file whose header is
+// written, returns an error message or an empty string on success
+// This may run on the I/O thread, so it must not abort
+std::string
+writeSprayChunk(
+  const std::string& file,
+  const Vector<Long>& col_offsets,
+  const Vector<Vector<char>>& payloads)
+{
+  std::fstream fs(file, std::ios::in | std::ios::out | std::ios::binary);
+  if (!fs.good())
+    return "Unable to open binary spray file " + file;
+  const int ncols = payloads.size();
+  for (int c = 0; c < ncols; ++c) {
+    fs.seekp(col_offsets[c]);
+    fs.write(payloads[c].data(), payloads[c].size());
+  }
+  if (!fs.good())
+    return "Unable to write binary spray file " + file;
+  return std::string();
+}
+} // namespace
+
+void
+readSprayFileHeader(std::istream& is, SprayFileHeader& hdr)
+{
+  char magic[magic_len];
+  is.read(magic, magic_len);
+  if (!is.good() || std::strncmp(magic, spray_binary_magic, magic_len) != 0)
+    Abort("Not a binary spray particle file");
+  int version = 0;
+  readValue(is, version);
+  if (version > spray_binary_version)
+    Abort("Unsupported binary spray file version");
+  readValue(is, hdr.dim);
+  readValue(is, hdr.ncomp);
+  readValue(is, hdr.flags);
+  readValue(is, hdr.nparticles);
+  Long nchunks = 0;
+  readValue(is, nchunks);
+  hdr.names.resize(hdr.ncomp);
+  for (int c = 0; c < hdr.ncomp; ++c) {
+    int len = 0;
+    readValue(is, len);
+    hdr.names[c].resize(len);
+    is.read(&hdr.names[c][0], len);
+  }
+  const int ncols = hdr.numColumns();
+  hdr.chunks.resize(nchunks);
+  Long total = 0;
+  for (auto& chunk : hdr.chunks) {
+    readValue(is, chunk.count);
+    chunk.cols.resize(ncols);
+    for (auto& col : chunk.cols) {
+      readValue(is, col.offset);
+      readValue(is, col.nbytes);
+      readValue(is, col.codec);
+    }
+    total += chunk.count;
+  }
+  if (!is.good() || total != hdr.nparticles)
+    Abort("Binary spray file header is corrupt");
+}
+
+void
+writeSprayFileHeader(std::ostream& os, const SprayFileHeader& hdr)
+{
+  os.write(spray_binary_magic, magic_len);
+  writeValue(os, spray_binary_version);
+  writeValue(os, hdr.dim);
+  writeValue(os, hdr.ncomp);
+  writeValue(os, hdr.flags);
+  writeValue(os, hdr.nparticles);
+  writeValue(os, static_cast<Long>(hdr.chunks.size()));
+  for (int c = 0; c < hdr.ncomp; ++c) {
+    const int len = hdr.names[c].size();
+    writeValue(os, len);
+    os.write(hdr.names[c].data(), len);
+  }
+  for (const auto& chunk : hdr.chunks) {
+    writeValue(os, chunk.count);
+    for (const auto& col : chunk.cols) {
+      writeValue(os, col.offset);
+      writeValue(os, col.nbytes);
+      writeValue(os, col.codec);
+    }
+  }
+}
+
+Long
+sprayFileHeaderSize(const SprayFileHeader& hdr)
+{
+  Long hsize = magic_len + 4 * sizeof(int) + 2 * sizeof(Long);
+  for (int c = 0; c < hdr.ncomp; ++c)
+    hsize += sizeof(int) + hdr.names[c].size();
+  const Long col_size = 2 * sizeof(Long) + sizeof(int);
+  hsize += hdr.chunks.size() * (sizeof(Long) + hdr.numColumns() * col_size);
+  return hsize;
+}
+
+int
+encodeSprayColumn(
+  const double* vals,
+  const Long count,
+  const int vsize,
+  const int codec,
+  Vector<char>& out)
+{
+  const Long nbytes = count * vsize;
+  std::vector<char> raw(nbytes);
+  for (Long n = 0; n < count; ++n) {
+    if (vsize == sizeof(float)) {
+      const float val = static_cast<float>(vals[n]);
+      std::memcpy(&raw[n * vsize], &val, vsize);
+    } else {
+      std::memcpy(&raw[n * vsize], &vals[n], vsize);
+    }
+  }
+  if (codec == spray_codec_shuffle_rle) {
+    // Group byte k of every value together, the high bytes of similar
+    // values then form long runs
+    std::vector<char> shuffled(nbytes);
+    for (Long n = 0; n < count; ++n) {
+      for (int k = 0; k < vsize; ++k)
+        shuffled[k * count + n] = raw[n * vsize + k];
+    }
+    // Run length encoding, a control byte c >= 0 is followed by c + 1
+    // literal bytes and c < 0 is followed by one byte repeated 1 - c times
+    out.clear();
+    out.reserve(nbytes);
+    Long i = 0;
+    while (i < nbytes) {
+      Long run = 1;
+      while (i + run < nbytes && run < 128 && shuffled[i + run] == shuffled[i])
+        ++run;
+      if (run >= 3) {
+        out.push_back(static_cast<char>(1 - run));
+        out.push_back(shuffled[i]);
+        i += run;
+      } else {
+        // Literals until the next run of three or 128 bytes
+        Long lit = 0;
+        while (i + lit < nbytes && lit < 128) {
+          const Long j = i + lit;
+          if (
+            j + 2 < nbytes && shuffled[j] == shuffled[j + 1] &&
+            shuffled[j] == shuffled[j + 2])
+            break;
+          ++lit;
+        }
+        out.push_back(static_cast<char>(lit - 1));
+        out.insert(out.end(), shuffled.begin() + i, shuffled.begin() + i + lit);
+        i += lit;
+      }
+      // Keep the raw values if they do not compress
+      if (static_cast<Long>(out.size()) >= nbytes)
+        break;
+    }
+    if (static_cast<Long>(out.size()) < nbytes)
+      return spray_codec_shuffle_rle;
+  }
+  out.assign(raw.begin(), raw.end());
+  return spray_codec_raw;
+}
+
+void
+decodeSprayColumn(
+  const char* in,
+  const Long nbytes,
+  const Long count,
+  const int vsize,
+  const int codec,
+  std::vector<char>& out)
+{
+  const Long raw_bytes = count * vsize;
+  if (codec == spray_codec_raw) {
+    out.assign(in, in + nbytes);
+    return;
+  }
+  if (codec != spray_codec_shuffle_rle)
+    Abort("Unsupported binary spray file codec");
+  std::vector<char> shuffled;
+  shuffled.reserve(raw_bytes);
+  Long i = 0;
+  while (i < nbytes) {
+    const int ctrl = static_cast<signed char>(in[i++]);
+    if (ctrl >= 0) {
+      if (i + ctrl + 1 > nbytes)
+        break;
+      shuffled.insert(shuffled.end(), in + i, in + i + ctrl + 1);
+      i += ctrl + 1;
+    } else {
+      if (i >= nbytes)
+        break;
+      shuffled.insert(shuffled.end(), 1 - ctrl, in[i++]);
+    }
+  }
+  if (static_cast<Long>(shuffled.size()) != raw_bytes)
+    Abort("Binary spray file column is corrupt");
+  out.resize(raw_bytes);
+  for (Long n = 0; n < count; ++n) {
+    for (int k = 0; k < vsize; ++k)
+      out[n * vsize + k] = shuffled[k * count + n];
+  }
+}
+
+void
+readSprayColumnRange(
+  std::istream& is,
+  const SprayFileHeader& hdr,
+  const int col,
+  const Long p0,
+  const Long p1,
+  Real* out)
+{
+  Long cstart = 0;
+  const int vsize = hdr.valueSize();
+  std::vector<char> packed;
+  std::vector<char> raw;
+  for (const auto& chunk : hdr.chunks) {
+    const Long cend = cstart + chunk.count;
+    const Long lo = amrex::max(p0, cstart);
+    const Long hi = amrex::min(p1, cend);
+    if (lo < hi) {
+      const SprayColumnInfo& cinfo = chunk.cols[col];
+      const char* src = nullptr;
+      if (cinfo.codec == spray_codec_raw) {
+        // Only read the requested values
+        raw.resize((hi - lo) * vsize);
+        is.seekg(cinfo.offset + (lo - cstart) * vsize);
+        is.read(raw.data(), raw.size());
+        src = raw.data();
+      } else {
+        // Compressed columns are decoded whole
+        packed.resize(cinfo.nbytes);
+        is.seekg(cinfo.offset);
+        is.read(packed.data(), packed.size());
+        decodeSprayColumn(
+          packed.data(), cinfo.nbytes, chunk.count, vsize, cinfo.codec, raw);
+        src = raw.data() + (lo - cstart) * vsize;
+      }
+      if (!is.good())
+        Abort("Unable to read binary spray file data");
+      for (Long n = 0; n < hi - lo; ++n) {
+        if (vsize == sizeof(float)) {
+          float val;
+          std::memcpy(&val, src + n * vsize, vsize);
+          out[lo - p0 + n] = val;
+        } else {
+          double val;
+          std::memcpy(&val, src + n * vsize, vsize);
+          out[lo - p0 + n] = val;
+        }
+      }
+    }
+    cstart = cend;
+    if (cstart >= p1)
+      break;
+  }
+}
+
+void
+SprayParticleContainer::readSprayBinaryFile(
+  const std::string& file, const int level)
+{
+  BL_PROFILE("SprayParticleContainer::readSprayBinaryFile()");
+  const int my_proc = ParallelDescriptor::MyProc();
+  std::ifstream ifs(file, std::ios::in | std::ios::binary);
+  if (!ifs.good())
+    Abort("Unable to open binary spray file " + file);
+  SprayFileHeader hdr;
+  readSprayFileHeader(ifs, hdr);
+  if (hdr.dim != AMREX_SPACEDIM)
+    Abort("Binary spray file dimension does not match");
+  const int nreal = NSR_SPR + NAR_SPR;
+  if (hdr.ncomp != nreal)
+    Abort(
+      "Binary spray file has " + std::to_string(hdr.ncomp) +
+      " components, expected " + std::to_string(nreal));
+  // Ranks that own boxes on this level read disjoint ranges of particles
+  const DistributionMapping& dm = this->ParticleDistributionMap(level);
+  const auto& pmap = dm.ProcessorMap();
+  std::vector<int> readers(pmap.begin(), pmap.end());
+  std::sort(readers.begin(), readers.end());
+  readers.erase(std::unique(readers.begin(), readers.end()), readers.end());
+  const auto rit = std::lower_bound(readers.begin(), readers.end(), my_proc);
+  Long p0 = 0;
+  Long p1 = 0;
+  if (rit != readers.end() && *rit == my_proc) {
+    const Long rindx = rit - readers.begin();
+    const Long nreaders = readers.size();
+    p0 = hdr.nparticles * rindx / nreaders;
+    p1 = hdr.nparticles * (rindx + 1) / nreaders;
+  }
+  const Long np = p1 - p0;
+  const int ncols = hdr.numColumns();
+  Vector<Vector<Real>> cols(ncols);
+  for (int c = 0; c < ncols; ++c) {
+    cols[c].resize(np);
+    readSprayColumnRange(ifs, hdr, c, p0, p1, cols[c].data());
+  }
+  ifs.close();
+  // Keep particles in local tiles, others are placed on the first local tile
+  // and moved by the redistribute
+  std::pair<int, int> transfer_ind(-1, -1);
+  {
+    MFIter mfi = MakeMFIter(level);
+    if (mfi.isValid())
+      transfer_ind = std::make_pair(mfi.index(), mfi.LocalTileIndex());
+  }
+  Long pid = 0;
+  if (np > 0) {
+    pid = ParticleType::NextID();
+    ParticleType::NextID(pid + np);
+  }
+  std::map<std::pair<int, int>, Gpu::HostVector<ParticleType>> host_particles;
+#ifdef USE_SPRAY_SOA
+  std::map<std::pair<int, int>, std::array<Gpu::HostVector<Real>, NAR_SPR>>
+    host_real_attribs;
+#endif
+  ParticleLocData pld;
+  Long num_lost = 0;
+  for (Long n = 0; n < np; ++n) {
+    ParticleType p;
+    p.id() = pid + n;
+    p.cpu() = my_proc;
+    // Key on the row in the file
+    p.idata(SPRAY_KEY_COMP) = sprayParticleKey(p0 + n, 0, 0., spray_key_file);
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+      p.pos(dir) = cols[dir][n];
+#ifndef USE_SPRAY_SOA
+    for (int c = 0; c < NSR_SPR; ++c)
+      p.rdata(c) = cols[AMREX_SPACEDIM + c][n];
+#endif
+    if (!Where(p, pld, level, level)) {
+      num_lost++;
+      continue;
+    }
+    std::pair<int, int> ind(pld.m_grid, pld.m_tile);
+    if (dm[pld.m_grid] != my_proc)
+      ind = transfer_ind;
+    host_particles[ind].push_back(p);
+#ifdef USE_SPRAY_SOA
+    for (int c = 0; c < NAR_SPR; ++c)
+      host_real_attribs[ind][c].push_back(cols[AMREX_SPACEDIM + c][n]);
+#endif
+  }
+  for (auto& kv : host_particles) {
+    const auto& src_tile = kv.second;
+    auto& dst_tile = GetParticles(level)[kv.first];
+    auto old_size = dst_tile.GetArrayOfStructs().size();
+    auto new_size = old_size + src_tile.size();
+    dst_tile.resize(new_size);
+    Gpu::copy(
+      Gpu::hostToDevice, src_tile.begin(), src_tile.end(),
+      dst_tile.GetArrayOfStructs().begin() + old_size);
+#ifdef USE_SPRAY_SOA
+    for (int c = 0; c < NAR_SPR; ++c) {
+      Gpu::copy(
+        Gpu::hostToDevice, host_real_attribs[kv.first][c].begin(),
+        host_real_attribs[kv.first][c].end(),
+        dst_tile.GetStructOfArrays().GetRealData(c).begin() + old_size);
+    }
+#endif
+  }
+  Gpu::streamSynchronize();
+  ParallelDescriptor::ReduceLongSum(num_lost);
+  if (num_lost > 0 && ParallelDescriptor::IOProcessor()) {
+    amrex::Warning(
+      std::to_string(num_lost) + " particles in " + file +
+      " are outside of the domain and were removed");
+  }
+  Redistribute();
+}
+
+void
+SprayParticleContainer::writeSprayBinaryFile(
+  const std::string& file,
+  const Vector<std::string>& real_comp_names,
+  const bool is_plot)
+{
+  BL_PROFILE("SprayParticleContainer::writeSprayBinaryFile()");
+  // Only one snapshot is written in the background at a time
+  finishSprayBinaryWrite();
+  const int my_proc = ParallelDescriptor::MyProc();
+  const int nprocs = ParallelDescriptor::NProcs();
+  // Components and particles written, plot files can write a subset
+  Vector<int> comps;
+  const Vector<int> write_comp = plotRealComps(real_comp_names);
+  for (int c = 0; c < NSR_SPR + NAR_SPR; ++c) {
+    if (!is_plot || write_comp[c] == 1)
+      comps.push_back(c);
+  }
+  SprayPlotSelect select;
+  if (is_plot)
+    select = m_plotSelect;
+  const bool single = is_plot && m_plotSingle;
+  const int nreal = comps.size();
+  const int ncols = AMREX_SPACEDIM + nreal;
+  // Copy the valid particles on this rank into columns
+  Vector<Vector<double>> cols(ncols);
+  for (int lev = 0; lev <= finestLevel(); ++lev) {
+    for (MyParConstIter pti(*this, lev); pti.isValid(); ++pti) {
+      const Long np = pti.numParticles();
+      Gpu::HostVector<ParticleType> host_parts(np);
+      Gpu::copy(
+        Gpu::deviceToHost, pti.GetArrayOfStructs().begin(),
+        pti.GetArrayOfStructs().end(), host_parts.begin());
+#ifdef USE_SPRAY_SOA
+      std::array<Gpu::HostVector<Real>, NAR_SPR> host_attribs;
+      for (int c = 0; c < NAR_SPR; ++c) {
+        host_attribs[c].resize(np);
+        Gpu::copy(
+          Gpu::deviceToHost, pti.GetAttribs(c).begin(), pti.GetAttribs(c).end(),
+          host_attribs[c].begin());
+      }
+#endif
+      Gpu::streamSynchronize();
+      for (Long n = 0; n < np; ++n) {
+        const ParticleType& p = host_parts[n];
+        if (p.id() <= 0)
+          continue;
+        Real pos[AMREX_SPACEDIM];
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+          pos[dir] = p.pos(dir);
+        if (!select.keep(p.id(), p.cpu(), pos))
+          continue;
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+          cols[dir].push_back(pos[dir]);
+        for (int c = 0; c < nreal; ++c) {
+#ifdef USE_SPRAY_SOA
+          cols[AMREX_SPACEDIM + c].push_back(host_attribs[comps[c]][n]);
+#else
+          cols[AMREX_SPACEDIM + c].push_back(p.rdata(comps[c]));
+#endif
+        }
+      }
+    }
+  }
+  const Long my_count = cols[0].size();
+  // Every rank needs the particle counts of all ranks to build the chunk
+  // table, each group of ranks is written as one chunk by its first rank
+  Vector<Long> counts(nprocs, 0);
+  ParallelDescriptor::Gather(
+    &my_count, 1, counts.data(), 1, ParallelDescriptor::IOProcessorNumber());
+  ParallelDescriptor::Bcast(
+    counts.data(), nprocs, ParallelDescriptor::IOProcessorNumber());
+  int nwriters = m_snapshotWriters;
+  if (nwriters <= 0)
+    nwriters = 64;
+  nwriters = amrex::min(nwriters, nprocs);
+  auto group_of = [=](const int proc) {
+    return static_cast<int>(Long(proc) * nwriters / nprocs);
+  };
+  // Send the columns to the writer of the group
+  const int my_group = group_of(my_proc);
+  int writer = my_proc;
+  while (writer > 0 && group_of(writer - 1) == my_group)
+    --writer;
+  const int tag = ParallelDescriptor::SeqNum();
+  Vector<double> send_buf;
+  if (writer != my_proc && my_count > 0) {
+    send_buf.resize(ncols * my_count);
+    for (int c = 0; c < ncols; ++c)
+      std::copy(
+        cols[c].begin(), cols[c].end(), send_buf.begin() + c * my_count);
+    ParallelDescriptor::Send(send_buf.data(), send_buf.size(), writer, tag);
+  }
+  // Writers encode the columns of their chunk
+  const int vsize = single ? sizeof(float) : sizeof(double);
+  const int codec = m_snapshotCompress ? spray_codec_shuffle_rle
+                                       : spray_codec_raw;
+  Vector<Vector<char>> payloads(ncols);
+  Vector<Long> my_nbytes(ncols, 0);
+  Vector<int> my_codecs(ncols, spray_codec_raw);
+  if (writer == my_proc) {
+    Long group_count = 0;
+    for (int proc = my_proc; proc < nprocs && group_of(proc) == my_group;
+         ++proc)
+      group_count += counts[proc];
+    Vector<Vector<double>> chunk_cols(ncols);
+    for (int c = 0; c < ncols; ++c) {
+      chunk_cols[c].reserve(group_count);
+      chunk_cols[c].insert(chunk_cols[c].end(), cols[c].begin(), cols[c].end());
+    }
+    Vector<double> recv_buf;
+    for (int proc = my_proc + 1; proc < nprocs && group_of(proc) == my_group;
+         ++proc) {
+      const Long np = counts[proc];
+      if (np == 0)
+        continue;
+      recv_buf.resize(ncols * np);
+      ParallelDescriptor::Recv(recv_buf.data(), recv_buf.size(), proc, tag);
+      for (int c = 0; c < ncols; ++c) {
+        chunk_cols[c].insert(
+          chunk_cols[c].end(), recv_buf.begin() + c * np,
+          recv_buf.begin() + (c + 1) * np);
+      }
+    }
+    for (int c = 0; c < ncols; ++c) {
+      my_codecs[c] = encodeSprayColumn(
+        chunk_cols[c].data(), group_count, vsize, codec, payloads[c]);
+      my_nbytes[c] = payloads[c].size();
+    }
+  }
+  // The IO rank needs the size of every column to write the chunk table
+  Vector<Long> nbytes(nprocs * ncols, 0);
+  Vector<int> codecs(nprocs * ncols, spray_codec_raw);
+  ParallelDescriptor::Gather(
+    my_nbytes.data(), ncols, nbytes.data(), ncols,
+    ParallelDescriptor::IOProcessorNumber());
+  ParallelDescriptor::Gather(
+    my_codecs.data(), ncols, codecs.data(), ncols,
+    ParallelDescriptor::IOProcessorNumber());
+  SprayFileHeader hdr;
+  hdr.ncomp = nreal;
+  if (single)
+    hdr.flags |= spray_binary_single;
+  hdr.names.resize(nreal);
+  for (int c = 0; c < nreal; ++c)
+    hdr.names[c] = real_comp_names[comps[c]];
+  hdr.chunks.resize(nwriters);
+  for (int proc = 0; proc < nprocs; ++proc) {
+    hdr.chunks[group_of(proc)].count += counts[proc];
+    hdr.nparticles += counts[proc];
+  }
+  for (auto& chunk : hdr.chunks)
+    chunk.cols.resize(ncols);
+  for (int proc = 0; proc < nprocs; ++proc) {
+    if (proc > 0 && group_of(proc - 1) == group_of(proc))
+      continue;
+    auto& chunk = hdr.chunks[group_of(proc)];
+    for (int c = 0; c < ncols; ++c) {
+      chunk.cols[c].nbytes = nbytes[proc * ncols + c];
+      chunk.cols[c].codec = codecs[proc * ncols + c];
+    }
+  }
+  Long offset = sprayFileHeaderSize(hdr);
+  for (auto& chunk : hdr.chunks) {
+    for (auto& col : chunk.cols) {
+      col.offset = offset;
+      offset += col.nbytes;
+    }
+  }
+  // Writers only need the offsets of their own chunk
+  Vector<Long> offsets(nwriters * ncols, 0);
+  if (ParallelDescriptor::IOProcessor()) {
+    for (int g = 0; g < nwriters; ++g) {
+      for (int c = 0; c < ncols; ++c)
+        offsets[g * ncols + c] = hdr.chunks[g].cols[c].offset;
+    }
+    std::ofstream ofs(file, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!ofs.good())
+      FileOpenFailed(file);
+    writeSprayFileHeader(ofs, hdr);
+  }
+  ParallelDescriptor::Bcast(
+    offsets.data(), offsets.size(), ParallelDescriptor::IOProcessorNumber());
+  if (writer == my_proc && hdr.chunks[my_group].count > 0) {
+    Vector<Long> col_offsets(
+      offsets.begin() + my_group * ncols,
+      offsets.begin() + (my_group + 1) * ncols);
+    if (m_asyncIO) {
+      // The staged columns are owned by the I/O thread, which is waited
+      // on before the next snapshot or at shutdown, where any error is
+      // raised on the main thread
+      m_snapshotWrite = std::async(
+        std::launch::async,
+        [file, col_offsets, payloads = std::move(payloads)]() {
+          return writeSprayChunk(file, col_offsets, payloads);
+        });
+    } else {
+      const std::string err = writeSprayChunk(file, col_offsets, payloads);
+      if (!err.empty())
+        Abort(err);
+    }
+  }
+  if (!m_asyncIO)
+    ParallelDescriptor::Barrier();
+}
+
+void
+SprayParticleContainer::finishSprayBinaryWrite()
+{
+  if (m_snapshotWrite.valid()) {
+    BL_PROFILE("SprayParticleContainer::finishSprayBinaryWrite()");
+    const std::string err = m_snapshotWrite.get();
+    if (!err.empty())
+      Abort(err);
+  }
+}
+
+Vector<int>
+SprayParticleContainer::plotRealComps(
+  const Vector<std::string>& real_comp_names) const
+{
+  const int nreal = real_comp_names.size();
+  Vector<int> write_comp(nreal, m_plotVars.empty() ? 1 : 0);
+  for (const auto& var : m_plotVars) {
+    const auto it =
+      std::find(real_comp_names.begin(), real_comp_names.end(), var);
+    if (it == real_comp_names.end())
+      Abort("Unknown spray component " + var + " in particles.plot_vars");
+    write_comp[it - real_comp_names.begin()] = 1;
+  }
+  return write_comp;
+}
@@ -0,0 +1,225 @@
+#include "SprayParticles.H"
+#include "SprayRandom.H"
+#include <AMReX_DenseBins.H>
+
+using namespace amrex;
+
+namespace {
+// Pointers to the particle data of a tile
+struct CollideTile
+{
+  SprayParticleContainer::ParticleType* pstruct;
+#ifdef USE_SPRAY_SOA
+  GpuArray<Real*, NAR_SPR> rdata;
+#endif
+
+  AMREX_GPU_HOST_DEVICE
+  AMREX_FORCE_INLINE
+  Real& rd(const int pid, const int comp) const
+  {
+#ifdef USE_SPRAY_SOA
+    return rdata[comp][pid];
+#else
+    return pstruct[pid].rdata(comp);
+#endif
+  }
+};
+
+// Liquid density and specific heat from the fuel mass fractions
+AMREX_GPU_DEVICE
+AMREX_FORCE_INLINE
+void
+liquidProps(
+  const CollideTile& ct,
+  const int pid,
+  const SprayComps& SPI,
+  const SprayData& fdat,
+  Real& rho_part,
+  Real& cp_part)
+{
+  rho_part = 0.;
+  cp_part = 0.;
+  for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf) {
+    const Real Y = ct.rd(pid, SPI.pstateY + spf);
+    rho_part += Y / fdat.rho[spf];
+    cp_part += Y * fdat.cp[spf];
+  }
+  rho_part = 1. / rho_part;
+}
+
+// O'Rourke collision of the parcels i and j, each holding num_ppp droplets.
+// The parcels are randomly paired within a cell, so the collision frequency
+// is scaled by the number of other parcels in the cell
+AMREX_GPU_DEVICE
+AMREX_INLINE
+void
+collideParcels(
+  const CollideTile& ct,
+  const int i,
+  const int j,
+  const int num_others,
+  const SprayComps& SPI,
+  const SprayData& fdat,
+  const Real num_ppp,
+  const Real inv_vol,
+  const Real dt,
+  SprayRandom& rng)
+{
+  auto& pi = ct.pstruct[i];
+  auto& pj = ct.pstruct[j];
+  // Skip removed particles and wall films
+  if (pi.id() <= 0 || pj.id() <= 0)
+    return;
+  if (ct.rd(i, SPI.pstateT) <= 0. || ct.rd(j, SPI.pstateT) <= 0.)
+    return;
+  Real dv2 = 0.;
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    const Real dv =
+      ct.rd(i, SPI.pstateVel + dir) - ct.rd(j, SPI.pstateVel + dir);
+    dv2 += dv * dv;
+  }
+  if (dv2 <= 0.)
+    return;
+  const Real dvmag = std::sqrt(dv2);
+  const Real ri = 0.5 * ct.rd(i, SPI.pstateDia);
+  const Real rj = 0.5 * ct.rd(j, SPI.pstateDia);
+  const Real rsum = ri + rj;
+  // Collision frequency of a droplet in one parcel with the other parcel
+  const Real nu = num_ppp * M_PI * rsum * rsum * dvmag * inv_vol;
+  const Real prob = 1. - std::exp(-nu * dt * num_others);
+  if (rng.uniform() >= prob)
+    return;
+  Real rho_i, cp_i, rho_j, cp_j;
+  liquidProps(ct, i, SPI, fdat, rho_i, cp_i);
+  liquidProps(ct, j, SPI, fdat, rho_j, cp_j);
+  const Real mi = M_PI / 6. * rho_i * 8. * ri * ri * ri;
+  const Real mj = M_PI / 6. * rho_j * 8. * rj * rj * rj;
+  const Real mtot = mi + mj;
+  // Collector is the larger droplet
+  const bool i_large = ri >= rj;
+  const Real rl = i_large ? ri : rj;
+  const Real rs = i_large ? rj : ri;
+  const Real rho_s = i_large ? rho_j : rho_i;
+  const Real We = rho_s * dv2 * rs / fdat.sigma;
+  const Real gam = rl / rs;
+  const Real fgam = gam * gam * gam - 2.4 * gam * gam + 2.7 * gam;
+  const Real bcrit2 = rsum * rsum * amrex::min(1., 2.4 * fgam / We);
+  const Real b2 = rsum * rsum * rng.uniform();
+  if (b2 < bcrit2) {
+    // Coalescence, every droplet of the smaller parcel merges with a droplet
+    // of the collector parcel, which keeps the combined mass and momentum
+    const int keep = i_large ? i : j;
+    const int drop = i_large ? j : i;
+    const Real mk = i_large ? mi : mj;
+    const Real md = i_large ? mj : mi;
+    const Real cpk = i_large ? cp_i : cp_j;
+    const Real cpd = i_large ? cp_j : cp_i;
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      Real& uk = ct.rd(keep, SPI.pstateVel + dir);
+      uk = (mk * uk + md * ct.rd(drop, SPI.pstateVel + dir)) / mtot;
+    }
+    Real& Tk = ct.rd(keep, SPI.pstateT);
+    Tk = (mk * cpk * Tk + md * cpd * ct.rd(drop, SPI.pstateT)) /
+         (mk * cpk + md * cpd);
+    Real inv_rho = 0.;
+    for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf) {
+      Real& Yk = ct.rd(keep, SPI.pstateY + spf);
+      Yk = (mk * Yk + md * ct.rd(drop, SPI.pstateY + spf)) / mtot;
+      inv_rho += Yk / fdat.rho[spf];
+    }
+    ct.rd(keep, SPI.pstateDia) = std::cbrt(6. * mtot * inv_rho / M_PI);
+    ct.pstruct[drop].id() = -1;
+  } else {
+    // Grazing collision, the droplets keep their mass and exchange momentum
+    const Real bcrit = std::sqrt(bcrit2);
+    const Real fac = (std::sqrt(b2) - bcrit) / (rsum - bcrit);
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      Real& ui = ct.rd(i, SPI.pstateVel + dir);
+      Real& uj = ct.rd(j, SPI.pstateVel + dir);
+      const Real mom = mi * ui + mj * uj;
+      const Real du = ui - uj;
+      ui = (mom + mj * du * fac) / mtot;
+      uj = (mom - mi * du * fac) / mtot;
+    }
+  }
+}
+} // namespace
+
+void
+SprayParticleContainer::sprayCollision(
+  const int level, const Real dt, const Real time)
+{
+  BL_PROFILE("SprayParticleContainer::sprayCollision()");
+  if (m_sprayData->sigma <= 0.)
+    Abort("particles.use_collision_model requires particles.fuel_sigma");
+  const Geometry& geom = this->Geom(level);
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  const auto dx = geom.CellSizeArray();
+  const IntVect domlo = geom.Domain().smallEnd();
+  const IntVect domlen = geom.Domain().length();
+  const Real inv_vol = 1. / AMREX_D_TERM(dx[0], *dx[1], *dx[2]);
+  const Real num_ppp = m_parcelSize;
+  const SprayComps SPI = m_sprayIndx;
+  const SprayData* fdat = d_sprayData;
+  for (MyParIter pti(*this, level); pti.isValid(); ++pti) {
+    const int Np = pti.numParticles();
+    if (Np < 2)
+      continue;
+    const Box tile_box = pti.tilebox();
+    CollideTile ct;
+    ct.pstruct = &(pti.GetArrayOfStructs()[0]);
+#ifdef USE_SPRAY_SOA
+    for (int n = 0; n < NAR_SPR; ++n)
+      ct.rdata[n] = pti.GetStructOfArrays().GetRealData(n).data();
+#endif
+    // Bin the particles by cell, particles that have left the tile are
+    // binned in the closest cell of the tile
+    const IntVect blo = tile_box.smallEnd();
+    const IntVect bhi = tile_box.bigEnd();
+    DenseBins<ParticleType> bins;
+    bins.build(
+      Np, ct.pstruct, tile_box,
+      [=] AMREX_GPU_DEVICE(const ParticleType& p) noexcept -> IntVect {
+        IntVect iv;
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+          const Real lx = (p.pos(dir) - plo[dir]) * dxi[dir];
+          const int ic = static_cast<int>(std::floor(lx)) + domlo[dir];
+          iv[dir] = amrex::max(blo[dir], amrex::min(bhi[dir], ic));
+        }
+        return iv;
+      });
+    auto* perm = bins.permutationPtr();
+    const auto* offsets = bins.offsetsPtr();
+    const int ncells = static_cast<int>(tile_box.numPts());
+    const auto lo = amrex::lbound(tile_box);
+    const auto len = amrex::length(tile_box);
+    amrex::ParallelFor(ncells, [=] AMREX_GPU_DEVICE(int c) noexcept {
+      const int start = offsets[c];
+      const int num_parts = offsets[c + 1] - start;
+      if (num_parts < 2)
+        return;
+      const IntVect iv(AMREX_D_DECL(
+        c % len.x + lo.x, (c / len.x) % len.y + lo.y,
+        c / (len.x * len.y) + lo.z));
+      Long cid = 0;
+      for (int dir = AMREX_SPACEDIM - 1; dir >= 0; --dir)
+        cid = cid * domlen[dir] + (iv[dir] - domlo[dir]);
+      SprayRandom rng(cid, level, time, spray_rng_collision);
+      // Shuffle the parcels in the cell and collide them in pairs
+      for (int n = num_parts - 1; n > 0; --n) {
+        const int m = amrex::min(n, static_cast<int>(rng.uniform() * (n + 1)));
+        const auto tmp = perm[start + n];
+        perm[start + n] = perm[start + m];
+        perm[start + m] = tmp;
+      }
+      for (int n = 0; n + 1 < num_parts; n += 2) {
+        collideParcels(
+          ct, perm[start + n], perm[start + n + 1], num_parts - 1, SPI, *fdat,
+          num_ppp, inv_vol, dt, rng);
+      }
+    });
+    // The bins must remain allocated until the kernel is finished
+    Gpu::streamSynchronize();
+  }
+}
@@ -0,0 +1,202 @@
+#ifdef AMREX_USE_EB
+#include "SprayParticles.H"
+#include "SprayInterpolation.H"
+#include <AMReX_EBFArrayBox.H>
+#include <AMReX_Scan.H>
+
+using namespace amrex;
+
+void
+SprayParticleContainer::buildEBInterpData(
+  const int level, const MultiFab& state)
+{
+  const auto& factory =
+    dynamic_cast<EBFArrayBoxFactory const&>(state.Factory());
+  const auto& flagmf = factory.getMultiEBCellFlagFab();
+  // Determining which cells need cached geometry requires flags from
+  // two cells below to one cell above. The mask also covers the path of
+  // each particle in check_wall, so it uses as many ghost cells as the
+  // flags allow rather than the state ghost cells
+  const int ngrow = flagmf.nGrow() - 2;
+  if (level >= m_EBStencilMask.size()) {
+    m_EBStencilMask.resize(level + 1);
+    m_EBInterpGeom.resize(level + 1);
+  }
+  auto& maskmf = m_EBStencilMask[level];
+  // Only rebuild if the data is not consistent with the current grids
+  if (
+    maskmf && maskmf->boxArray() == state.boxArray() &&
+    maskmf->DistributionMap() == state.DistributionMap() &&
+    maskmf->nGrow() == ngrow)
+    return;
+  BL_PROFILE("SprayParticleContainer::buildEBInterpData()");
+  const auto dxarr = this->Geom(level).CellSizeArray();
+  const RealVect dx(AMREX_D_DECL(dxarr[0], dxarr[1], dxarr[2]));
+  const auto& cellcent = factory.getCentroid();
+  const auto& bndrycent = factory.getBndryCent();
+  const auto& bndrynorm = factory.getBndryNormal();
+  const auto& volfrac = factory.getVolFrac();
+  maskmf = std::make_unique<iMultiFab>(
+    state.boxArray(), state.DistributionMap(), 2, ngrow);
+  m_EBInterpGeom[level] = std::make_unique<EBGeomLayout>(
+    state.boxArray(), state.DistributionMap());
+  auto& geomlayout = *m_EBInterpGeom[level];
+  // Cached geometry is stored per box, so no tiling here
+  for (MFIter mfi(*maskmf); mfi.isValid(); ++mfi) {
+    const Box bx = mfi.growntilebox();
+    auto const& maskarr = maskmf->array(mfi);
+    const EBCellFlagFab& flags = flagmf[mfi];
+    auto& geomvec = geomlayout[mfi];
+    auto const& flags_array = flags.const_array();
+    if (flags.getType(amrex::grow(bx, 2)) != FabType::singlevalued) {
+      // No cut cells are near this box so no geometry is cached
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          maskarr(i, j, k, 0) = eb_stencil_mask(i, j, k, flags_array);
+          maskarr(i, j, k, 1) = -1;
+        });
+      geomvec.clear();
+      continue;
+    }
+    auto const& ccent = cellcent.const_array(mfi);
+    auto const& bcent = bndrycent.const_array(mfi);
+    auto const& bnorm = bndrynorm.const_array(mfi);
+    auto const& vfrac = volfrac.const_array(mfi);
+    const Dim3 lo = amrex::lbound(bx);
+    const int lenx = bx.length(0);
+    const int leny = bx.length(1);
+    const int npts = static_cast<int>(bx.numPts());
+    // Assign each cell needing geometry an index into the cache
+    const int ngeom = Scan::PrefixSum<int>(
+      npts,
+      [=] AMREX_GPU_DEVICE(int n) -> int {
+        const int k = n / (lenx * leny) + lo.z;
+        const int j = (n / lenx) % leny + lo.y;
+        const int i = n % lenx + lo.x;
+        return eb_needs_geom(i, j, k, flags_array);
+      },
+      [=] AMREX_GPU_DEVICE(int n, int const& s) {
+        const int k = n / (lenx * leny) + lo.z;
+        const int j = (n / lenx) % leny + lo.y;
+        const int i = n % lenx + lo.x;
+        maskarr(i, j, k, 0) = eb_stencil_mask(i, j, k, flags_array);
+        maskarr(i, j, k, 1) = eb_needs_geom(i, j, k, flags_array) ? s : -1;
+      },
+      Scan::Type::exclusive, Scan::retSum);
+    geomvec.resize(ngeom);
+    EBInterpGeom* geomptr = geomvec.data();
+    amrex::ParallelFor(
+      bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        const int gindx = maskarr(i, j, k, 1);
+        if (gindx >= 0) {
+          const bool is_cut = eb_mask_test(maskarr(i, j, k, 0), eb_cut_cell);
+          fill_eb_interp_geom(
+            i, j, k, dx, is_cut, ccent, bcent, bnorm, vfrac, geomptr[gindx]);
+        }
+      });
+  }
+  Gpu::streamSynchronize();
+}
+
+void
+SprayParticleContainer::redistributeSpraySource(
+  const int level,
+  MultiFab& tmp_source,
+  const MultiFab& source)
+{
+  if (m_EBRedistVFrac <= 0.)
+    return;
+  // Use the EB data from either of the source MultiFabs
+  const auto* factory =
+    dynamic_cast<EBFArrayBoxFactory const*>(&(tmp_source.Factory()));
+  if (factory == nullptr)
+    factory = dynamic_cast<EBFArrayBoxFactory const*>(&(source.Factory()));
+  if (
+    factory == nullptr || factory->boxArray() != tmp_source.boxArray() ||
+    factory->DistributionMap() != tmp_source.DistributionMap())
+    return;
+  BL_PROFILE("SprayParticleContainer::redistributeSpraySource()");
+  const auto& flagmf = factory->getMultiEBCellFlagFab();
+  const auto& volfrac = factory->getVolFrac();
+  // The neighborhood of a small cell one cell away is needed
+  if (flagmf.nGrow() < 2 || volfrac.nGrow() < 2)
+    return;
+  // Only the valid cells are redistributed, the small cells across box
+  // boundaries are read from a scratch copy so the ghost cell deposits in
+  // tmp_source are left for transferSource to add to the flow source
+  const int ncomp = tmp_source.nComp();
+  MultiFab src_fill(
+    tmp_source.boxArray(), tmp_source.DistributionMap(), ncomp, 1,
+    MFInfo().SetArena(The_Async_Arena()));
+  src_fill.setVal(0.);
+  MultiFab::Copy(src_fill, tmp_source, 0, 0, ncomp, 0);
+  src_fill.FillBoundary(Geom(level).periodicity());
+  const Box domain = Geom(level).growPeriodicDomain(2);
+  const Real vf_small = m_EBRedistVFrac;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+  for (MFIter mfi(tmp_source, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const Box bx = mfi.tilebox();
+    const EBCellFlagFab& flags = flagmf[mfi];
+    if (flags.getType(amrex::grow(bx, 2)) != FabType::singlevalued)
+      continue;
+    auto const& flags_array = flags.const_array();
+    auto const& vfrac = volfrac.const_array(mfi);
+    auto const& srcarr = tmp_source.array(mfi);
+    // Original source terms, with the neighboring boxes in the ghost cells
+    auto const& src_orig = src_fill.const_array(mfi);
+    const Box gbx = amrex::grow(bx, 1);
+    // Fraction of the source in each small cell given to each cell in its
+    // neighborhood, weighted by volume fraction
+    FArrayBox wgt_fab(gbx, 1, The_Async_Arena());
+    auto const& wgt = wgt_fab.array();
+    amrex::ParallelFor(
+      gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        wgt(i, j, k) = 0.;
+        const Real vf = vfrac(i, j, k);
+        if (
+          domain.contains(IntVect(AMREX_D_DECL(i, j, k))) && vf > 0. &&
+          vf < vf_small) {
+          Real vf_sum = 0.;
+          for (int kk = -1; kk < 2; ++kk) {
+            for (int jj = -1; jj < 2; ++jj) {
+              for (int ii = -1; ii < 2; ++ii) {
+                const IntVect iv(AMREX_D_DECL(i + ii, j + jj, k + kk));
+                if (
+                  domain.contains(iv) &&
+                  flags_array(i, j, k).isConnected(ii, jj, kk))
+                  vf_sum += vfrac(i + ii, j + jj, k + kk);
+              }
+            }
+          }
+          wgt(i, j, k) = vf / vf_sum;
+        }
+      });
+    amrex::ParallelFor(
+      bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        const Real vf = vfrac(i, j, k);
+        for (int n = 0; n < ncomp; ++n) {
+          Real src = (vf < vf_small) ? 0. : src_orig(i, j, k, n);
+          if (vf > 0.) {
+            // Gather from small cells whose neighborhood contains this cell
+            for (int kk = -1; kk < 2; ++kk) {
+              for (int jj = -1; jj < 2; ++jj) {
+                for (int ii = -1; ii < 2; ++ii) {
+                  const int is = i + ii;
+                  const int js = j + jj;
+                  const int ks = k + kk;
+                  if (
+                    wgt(is, js, ks) > 0. &&
+                    flags_array(is, js, ks).isConnected(-ii, -jj, -kk))
+                    src += wgt(is, js, ks) * src_orig(is, js, ks, n);
+                }
+              }
+            }
+          }
+          srcarr(i, j, k, n) = src;
+        }
+      });
+  }
+}
+#endif
@@ -0,0 +1,619 @@
+#include "SprayParticles.H"
+#include "SprayJetInjector.H"
+#include "SprayRandom.H"
+#include <algorithm>
+#include <limits>
+
+using namespace amrex;
+
+SprayJetInjector::SprayJetInjector(
+  const RealVect jet_cent,
+  const RealVect jet_norm,
+  const Real jet_dia,
+  const Real spray_angle,
+  const Real jet_vel,
+  const Real mass_flow_rate,
+  const Real part_temp,
+  const Real part_mean_dia,
+  const Real part_stdev_dia,
+  const Real* Y_jet,
+  const Real start_time,
+  const Real end_time)
+  : m_jetCent(jet_cent),
+    m_jetDia(jet_dia),
+    m_sprayAngle(spray_angle),
+    m_jetVel(jet_vel),
+    m_massFlow(mass_flow_rate),
+    m_partTemp(part_temp),
+    m_partMeanDia(part_mean_dia),
+    m_partStdevDia(part_stdev_dia),
+    m_startTime(start_time),
+    m_endTime(end_time)
+{
+  const Real mag = jet_norm.vectorLength();
+  if (mag <= 0.)
+    Abort("Spray jet normal must be nonzero");
+  m_jetNorm = jet_norm / mag;
+  for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf)
+    m_Y[spf] = Y_jet[spf];
+  // Find the vectors tangent to the jet inlet
+  m_t1 = RealVect::TheZeroVector();
+  m_t2 = RealVect::TheZeroVector();
+  int mindir = 0;
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    if (std::abs(m_jetNorm[dir]) > 1. - 1.E-12)
+      m_normDir = dir;
+    if (std::abs(m_jetNorm[dir]) < std::abs(m_jetNorm[mindir]))
+      mindir = dir;
+  }
+  if (m_normDir >= 0) {
+    const int d1 = (m_normDir == 0) ? 1 : 0;
+    m_t1[d1] = 1.;
+#if AMREX_SPACEDIM == 3
+    const int d2 = (m_normDir == 2) ? 1 : 2;
+    m_t2[d2] = 1.;
+#endif
+  } else {
+#if AMREX_SPACEDIM == 3
+    m_t1[mindir] = 1.;
+    m_t1 -= m_t1.dotProduct(m_jetNorm) * m_jetNorm;
+    m_t1 /= m_t1.vectorLength();
+    m_t2 = m_jetNorm.crossProduct(m_t1);
+#else
+    m_t1[0] = -m_jetNorm[1];
+    m_t1[1] = m_jetNorm[0];
+#endif
+  }
+}
+
+SprayInjectionProfile::SprayInjectionProfile(
+  const Vector<Real>& inject_time,
+  const Vector<Real>& inject_mass,
+  const Vector<Real>& inject_vel,
+  const Vector<Real>& inject_dia)
+  : m_time(inject_time),
+    m_mass(inject_mass),
+    m_vel(inject_vel),
+    m_dia(inject_dia)
+{
+  const int nvals = m_time.size();
+  if (
+    nvals < 2 || m_mass.size() != nvals || m_vel.size() != nvals ||
+    (!m_dia.empty() && m_dia.size() != nvals))
+    Abort("Spray injection tables must have matching sizes of at least 2");
+  // Precompute the integral of each piecewise linear segment
+  m_cumMass.resize(nvals);
+  m_cumMass[0] = 0.;
+  for (int i = 1; i < nvals; ++i) {
+    if (m_time[i] < m_time[i - 1])
+      Abort("Spray injection table times must be increasing");
+    m_cumMass[i] = m_cumMass[i - 1] + 0.5 * (m_time[i] - m_time[i - 1]) *
+                                        (m_mass[i] + m_mass[i - 1]);
+  }
+}
+
+int
+SprayInjectionProfile::segment(const Real time) const
+{
+  const int nvals = m_time.size();
+  const int i =
+    std::upper_bound(m_time.begin(), m_time.end(), time) - m_time.begin() - 1;
+  return amrex::max(0, amrex::min(nvals - 2, i));
+}
+
+Real
+SprayInjectionProfile::interpolate(
+  const Vector<Real>& vals, const Real time) const
+{
+  if (time <= m_time.front())
+    return vals.front();
+  if (time >= m_time.back())
+    return vals.back();
+  const int i = segment(time);
+  const Real dt = m_time[i + 1] - m_time[i];
+  const Real invt = (dt > 0.) ? (time - m_time[i]) / dt : 0.;
+  return vals[i] + (vals[i + 1] - vals[i]) * invt;
+}
+
+Real
+SprayInjectionProfile::cumulativeMass(const Real time) const
+{
+  if (time <= m_time.front())
+    return 0.;
+  if (time >= m_time.back())
+    return m_cumMass.back();
+  const int i = segment(time);
+  const Real mdot = interpolate(m_mass, time);
+  return m_cumMass[i] + 0.5 * (time - m_time[i]) * (m_mass[i] + mdot);
+}
+
+Real
+SprayInjectionProfile::injectedMass(const Real time0, const Real time1) const
+{
+  return cumulativeMass(time1) - cumulativeMass(time0);
+}
+
+Real
+SprayInjectionProfile::maxVelocity() const
+{
+  return *std::max_element(m_vel.begin(), m_vel.end());
+}
+
+void
+SprayJetInjector::setInjectionProfile(const SprayInjectionProfile& profile)
+{
+  m_profile = profile;
+  m_startTime = m_profile.startTime();
+  m_endTime = m_profile.endTime();
+}
+
+void
+SprayJetInjector::jetState(
+  const Real time,
+  const Real dt,
+  Real& inj_mass,
+  Real& vel,
+  Real& log_mean,
+  Real& log_stdev) const
+{
+  const Real mid_time = time + 0.5 * dt;
+  Real mean_dia = m_partMeanDia;
+  if (m_profile.empty()) {
+    const Real inj_time = amrex::min(time + dt, m_endTime) -
+                          amrex::max(time, m_startTime);
+    inj_mass = m_massFlow * amrex::max(inj_time, 0.);
+    vel = m_jetVel;
+  } else {
+    inj_mass = m_profile.injectedMass(time, time + dt);
+    vel = m_profile.velocity(mid_time);
+    if (m_profile.hasDiameter())
+      mean_dia = m_profile.diameter(mid_time);
+  }
+  // Parameters for the log normal distribution of diameters
+  const Real stdsq = m_partStdevDia * m_partStdevDia;
+  const Real meansq = mean_dia * mean_dia;
+  log_mean = 2. * std::log(mean_dia) - 0.5 * std::log(stdsq + meansq);
+  log_stdev = std::sqrt(
+    amrex::max(-2. * std::log(mean_dia) + std::log(stdsq + meansq), 0.));
+}
+
+Real
+SprayJetInjector::maxJetVel() const
+{
+  if (m_profile.empty())
+    return m_jetVel;
+  return m_profile.maxVelocity();
+}
+
+Real
+SprayJetInjector::avgParcelMass(
+  const Real rho_part,
+  const Real num_ppp,
+  const Real log_mean,
+  const Real log_stdev)
+{
+  // Mean of the diameter cubed for a log normal distribution
+  const Real dia3 = std::exp(3. * log_mean + 4.5 * log_stdev * log_stdev);
+  return num_ppp * M_PI / 6. * rho_part * dia3;
+}
+
+namespace {
+// Integral of sqrt(r^2 - x^2) from 0 to x
+Real
+circleSegInt(const Real x, const Real r)
+{
+  const Real xc = amrex::max(-r, amrex::min(r, x));
+  return 0.5 * (xc * std::sqrt(r * r - xc * xc) + r * r * std::asin(xc / r));
+}
+
+// Exact area of the intersection of the circle of radius r centered at the
+// origin with the rectangle [lo1, hi1] x [lo2, hi2]
+Real
+circleRectArea(
+  const Real r, const Real lo1, const Real hi1, const Real lo2, const Real hi2)
+{
+  const Real a = amrex::max(lo1, -r);
+  const Real b = amrex::min(hi1, r);
+  if (a >= b || lo2 >= hi2 || lo2 >= r || hi2 <= -r)
+    return 0.;
+  // Break points where the circle crosses the horizontal sides
+  Real xpts[6];
+  int npts = 0;
+  xpts[npts++] = a;
+  xpts[npts++] = b;
+  for (const Real y : {lo2, hi2}) {
+    if (std::abs(y) < r) {
+      const Real xs = std::sqrt(r * r - y * y);
+      if (xs > a && xs < b)
+        xpts[npts++] = xs;
+      if (-xs > a && -xs < b)
+        xpts[npts++] = -xs;
+    }
+  }
+  std::sort(xpts, xpts + npts);
+  const Real r2 = r * r;
+  Real area = 0.;
+  for (int n = 0; n < npts - 1; ++n) {
+    const Real x0 = xpts[n];
+    const Real x1 = xpts[n + 1];
+    if (x1 <= x0)
+      continue;
+    // The bounds of the integrand do not change between break points
+    const Real xm = 0.5 * (x0 + x1);
+    const Real sm = std::sqrt(r2 - xm * xm);
+    const Real segint = circleSegInt(x1, r) - circleSegInt(x0, r);
+    const bool upper_circ = sm < hi2;
+    const bool lower_circ = -sm > lo2;
+    const Real upper = upper_circ ? sm : hi2;
+    const Real lower = lower_circ ? -sm : lo2;
+    if (upper <= lower)
+      continue;
+    area += (upper_circ ? segint : hi2 * (x1 - x0)) -
+            (lower_circ ? -segint : lo2 * (x1 - x0));
+  }
+  return area;
+}
+} // namespace
+
+Real
+SprayJetInjector::overlapFraction(const RealBox& tile, SprayJetSample& js) const
+{
+  const Real jr = 0.5 * m_jetDia;
+  js.cent = m_jetCent;
+  js.norm = m_jetNorm;
+  js.t1 = m_t1;
+  js.t2 = m_t2;
+  js.jr2 = jr * jr;
+  js.spray_angle = m_sprayAngle;
+  js.part_temp = m_partTemp;
+  js.Y_jet = m_Y;
+  js.lo2 = 0.;
+  js.hi2 = 0.;
+  constexpr Real big = std::numeric_limits<Real>::max();
+  js.own_lo1 = -big;
+  js.own_hi1 = big;
+  js.own_lo2 = -big;
+  js.own_hi2 = big;
+  if (m_normDir < 0) {
+    // Inject the entire jet on the tile containing the center
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      if (m_jetCent[dir] < tile.lo(dir) || m_jetCent[dir] >= tile.hi(dir))
+        return 0.;
+    }
+    js.lo1 = -jr;
+    js.hi1 = jr;
+#if AMREX_SPACEDIM == 3
+    js.lo2 = -jr;
+    js.hi2 = jr;
+#endif
+    return 1.;
+  }
+  const int nd = m_normDir;
+  if (m_jetCent[nd] < tile.lo(nd) || m_jetCent[nd] >= tile.hi(nd))
+    return 0.;
+  const int d1 = (nd == 0) ? 1 : 0;
+  js.own_lo1 = tile.lo(d1) - m_jetCent[d1];
+  js.own_hi1 = tile.hi(d1) - m_jetCent[d1];
+  js.lo1 = amrex::max(js.own_lo1, -jr);
+  js.hi1 = amrex::min(js.own_hi1, jr);
+  if (js.lo1 >= js.hi1)
+    return 0.;
+#if AMREX_SPACEDIM == 3
+  const int d2 = (nd == 2) ? 1 : 2;
+  js.own_lo2 = tile.lo(d2) - m_jetCent[d2];
+  js.own_hi2 = tile.hi(d2) - m_jetCent[d2];
+  js.lo2 = amrex::max(js.own_lo2, -jr);
+  js.hi2 = amrex::min(js.own_hi2, jr);
+  if (js.lo2 >= js.hi2)
+    return 0.;
+  return circleRectArea(jr, js.lo1, js.hi1, js.lo2, js.hi2) / (M_PI * jr * jr);
+#else
+  return (js.hi1 - js.lo1) / m_jetDia;
+#endif
+}
+
+void
+SprayParticleContainer::buildSprayJetIndex(const int level)
+{
+  const BoxArray& ba = this->ParticleBoxArray(level);
+  const DistributionMapping& dm = this->ParticleDistributionMap(level);
+  if (level >= m_sprayJetBoxes.size())
+    m_sprayJetBoxes.resize(level + 1);
+  auto& jetboxes = m_sprayJetBoxes[level];
+  // Only rebuild if the grids have changed
+  if (
+    jetboxes && jetboxes->boxArray() == ba &&
+    jetboxes->DistributionMap() == dm &&
+    m_sprayJetsIndexed == static_cast<int>(m_sprayJets.size()))
+    return;
+  const Geometry& geom = this->Geom(level);
+  jetboxes = std::make_unique<LayoutData<Vector<int>>>(ba, dm);
+  for (MFIter mfi(*jetboxes); mfi.isValid(); ++mfi) {
+    const RealBox rb(mfi.validbox(), geom.CellSize(), geom.ProbLo());
+    auto& jet_list = (*jetboxes)[mfi];
+    jet_list.clear();
+    for (int jindx = 0; jindx < m_sprayJets.size(); ++jindx) {
+      SprayJetSample js;
+      if (m_sprayJets[jindx]->overlapFraction(rb, js) > 0.)
+        jet_list.push_back(jindx);
+    }
+  }
+  m_sprayJetsIndexed = m_sprayJets.size();
+}
+
+// Sample the inlet location of a parcel in the sampling region of js
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+sprayJetInlet(
+  const SprayJetSample& js, SprayRandom& rng, Real& loc1, Real& loc2)
+{
+  loc1 = 0.;
+  loc2 = 0.;
+  do {
+    loc1 = js.lo1 + (js.hi1 - js.lo1) * rng.uniform();
+#if AMREX_SPACEDIM == 3
+    loc2 = js.lo2 + (js.hi2 - js.lo2) * rng.uniform();
+#endif
+  } while (loc1 * loc1 + loc2 * loc2 > js.jr2);
+}
+
+// Index of the tile whose half open part of the inlet, stored as
+// {own_lo1, own_hi1, own_lo2, own_hi2}, contains the location, or -1 if
+// none of the ntiles tiles owns it
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE int
+sprayJetOwner(
+  const GpuArray<Real, 4>* owns, const int ntiles, const Real loc1,
+  const Real loc2)
+{
+  for (int t = 0; t < ntiles; ++t) {
+    if (
+      loc1 >= owns[t][0] && loc1 < owns[t][1] && loc2 >= owns[t][2] &&
+      loc2 < owns[t][3])
+      return t;
+  }
+  return -1;
+}
+
+bool
+SprayParticleContainer::sprayInjection(
+  const Real time, const Real dt, const int level)
+{
+  BL_PROFILE("SprayParticleContainer::sprayInjection()");
+  const int num_jets = m_sprayJets.size();
+  const Geometry& geom = this->m_gdb->Geom(level);
+  const auto dx = geom.CellSize();
+  const SprayData* fdat = m_sprayData;
+  // Sampling region of each jet within the domain and number of parcels
+  // injected by each jet
+  Vector<SprayJetSample> jet_samples(num_jets);
+  Vector<int> jet_parts(num_jets, 0);
+  bool any_active = false;
+  for (int jindx = 0; jindx < num_jets; ++jindx) {
+    const SprayJetInjector& jet = *m_sprayJets[jindx];
+    if (!jet.jetActive(time, dt))
+      continue;
+    any_active = true;
+    Real jet_mass = 0.;
+    Real jet_vel = 0.;
+    Real log_mean = 0.;
+    Real log_stdev = 0.;
+    jet.jetState(time, dt, jet_mass, jet_vel, log_mean, log_stdev);
+    // This absolutely must be included with any injection or insertion
+    // function or significant issues will arise
+    if (jet_vel * dt / dx[0] > 0.5) {
+      Real max_vel = dx[0] * 0.5 / dt;
+      if (ParallelDescriptor::IOProcessor()) {
+        std::string warn_msg = "Injection velocity of " +
+                               std::to_string(jet_vel) +
+                               " is reduced to maximum " +
+                               std::to_string(max_vel);
+        amrex::Warning(warn_msg);
+      }
+      m_injectVel = jet_vel;
+      jet_vel = max_vel;
+    }
+    if (jet_mass <= 0.)
+      continue;
+    Real rho_part = 0.;
+    for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf)
+      rho_part += jet.Y()[spf] / fdat->rho[spf];
+    rho_part = 1. / rho_part;
+    const Real parcel_mass = SprayJetInjector::avgParcelMass(
+      rho_part, m_parcelSize, log_mean, log_stdev);
+    SprayJetSample& js = jet_samples[jindx];
+    const Real jet_perc = jet.overlapFraction(geom.ProbDomain(), js);
+    js.jet_vel = jet_vel;
+    js.log_mean = log_mean;
+    js.log_stdev = log_stdev;
+    // Round randomly so the injected mass is correct on average, the count
+    // for the whole jet is the same on every rank
+    SprayRandom rng(jindx, 0, time, spray_rng_inject_count);
+    jet_parts[jindx] =
+      static_cast<int>(jet_perc * jet_mass / parcel_mass + rng.uniform());
+  }
+  if (!any_active)
+    return false;
+  buildSprayJetIndex(level);
+  const auto& jetboxes = *m_sprayJetBoxes[level];
+  // Parcels injected into each local tile, which are the entries start to
+  // start + num_parts of tile_parcels
+  struct TileInject
+  {
+    int grid;
+    int tile;
+    int jindx;
+    Long num_parts;
+    Long start;
+  };
+  Vector<TileInject> tiles;
+  // Local tiles touched by each jet and the part of the inlet each owns
+  Vector<Vector<int>> jet_tiles(num_jets);
+  Vector<Vector<GpuArray<Real, 4>>> jet_owns(num_jets);
+  for (MFIter mfi = MakeMFIter(level); mfi.isValid(); ++mfi) {
+    const RealBox tilebox(mfi.tilebox(), dx, geom.ProbLo());
+    // Only check the jets that touch this box
+    for (const int jindx : jetboxes[mfi]) {
+      if (jet_parts[jindx] == 0)
+        continue;
+      SprayJetSample tile_js;
+      if (m_sprayJets[jindx]->overlapFraction(tilebox, tile_js) <= 0.)
+        continue;
+      jet_tiles[jindx].push_back(static_cast<int>(tiles.size()));
+      jet_owns[jindx].push_back(
+        {tile_js.own_lo1, tile_js.own_hi1, tile_js.own_lo2, tile_js.own_hi2});
+      tiles.push_back({mfi.index(), mfi.LocalTileIndex(), jindx, 0, 0});
+    }
+  }
+  // Each rank samples the inlet location of every parcel of a jet once and
+  // buckets the parcels by the local tile owning the location. The random
+  // numbers of a parcel are keyed on the jet and the parcel ordinal within
+  // the jet, so the injected parcels do not depend on the domain
+  // decomposition or tiling
+  Gpu::HostVector<int> host_parcels;
+  for (int jindx = 0; jindx < num_jets; ++jindx) {
+    const int ntiles = static_cast<int>(jet_tiles[jindx].size());
+    if (ntiles == 0)
+      continue;
+    const int num_jet_parts = jet_parts[jindx];
+    const SprayJetSample js = jet_samples[jindx];
+    Gpu::DeviceVector<GpuArray<Real, 4>> owns(ntiles);
+    Gpu::copy(
+      Gpu::hostToDevice, jet_owns[jindx].begin(), jet_owns[jindx].end(),
+      owns.begin());
+    Gpu::DeviceVector<int> owner(num_jet_parts);
+    Gpu::DeviceVector<int> owned_n(num_jet_parts);
+    Gpu::DeviceVector<int> owned_t(num_jet_parts);
+    const GpuArray<Real, 4>* owns_ptr = owns.data();
+    int* owner_ptr = owner.data();
+    int* on_ptr = owned_n.data();
+    int* ot_ptr = owned_t.data();
+    amrex::ParallelFor(num_jet_parts, [=] AMREX_GPU_DEVICE(int n) noexcept {
+      SprayRandom rng(n, jindx, time, spray_rng_inject);
+      Real loc1, loc2;
+      sprayJetInlet(js, rng, loc1, loc2);
+      owner_ptr[n] = sprayJetOwner(owns_ptr, ntiles, loc1, loc2);
+    });
+    // Compact the parcels owned by a local tile, in order of the ordinal
+    const int num_owned = Scan::PrefixSum<int>(
+      num_jet_parts,
+      [=] AMREX_GPU_DEVICE(int n) -> int { return owner_ptr[n] >= 0; },
+      [=] AMREX_GPU_DEVICE(int n, int const& s) {
+        if (owner_ptr[n] >= 0) {
+          on_ptr[s] = n;
+          ot_ptr[s] = owner_ptr[n];
+        }
+      },
+      Scan::Type::exclusive, Scan::retSum);
+    if (num_owned == 0)
+      continue;
+    Gpu::HostVector<int> h_owned_n(num_owned);
+    Gpu::HostVector<int> h_owned_t(num_owned);
+    Gpu::copy(
+      Gpu::deviceToHost, owned_n.begin(), owned_n.begin() + num_owned,
+      h_owned_n.begin());
+    Gpu::copy(
+      Gpu::deviceToHost, owned_t.begin(), owned_t.begin() + num_owned,
+      h_owned_t.begin());
+    // Stable counting sort of the owned parcels by tile
+    Vector<Long> tstart(ntiles + 1, 0);
+    for (int m = 0; m < num_owned; ++m)
+      tstart[h_owned_t[m] + 1]++;
+    for (int t = 0; t < ntiles; ++t)
+      tstart[t + 1] += tstart[t];
+    const Long base = host_parcels.size();
+    host_parcels.resize(base + num_owned);
+    Vector<Long> tpos(tstart.begin(), tstart.end() - 1);
+    for (int m = 0; m < num_owned; ++m)
+      host_parcels[base + tpos[h_owned_t[m]]++] = h_owned_n[m];
+    for (int t = 0; t < ntiles; ++t) {
+      TileInject& tinj = tiles[jet_tiles[jindx][t]];
+      tinj.start = base + tstart[t];
+      tinj.num_parts = tstart[t + 1] - tstart[t];
+    }
+  }
+  const Long total_parts = host_parcels.size();
+  if (total_parts == 0)
+    return true;
+  Gpu::DeviceVector<int> tile_parcels(total_parts);
+  Gpu::copy(
+    Gpu::hostToDevice, host_parcels.begin(), host_parcels.end(),
+    tile_parcels.begin());
+  // Reserve a block of IDs for all new parcels on this rank
+  Long pid = ParticleType::NextID();
+  ParticleType::NextID(pid + total_parts);
+  const int my_proc = ParallelDescriptor::MyProc();
+  const SprayComps SPI = m_sprayIndx;
+  for (const auto& tinj : tiles) {
+    if (tinj.num_parts == 0)
+      continue;
+    auto& particle_tile =
+      GetParticles(level)[std::make_pair(tinj.grid, tinj.tile)];
+    const Long old_size = particle_tile.GetArrayOfStructs().size();
+    particle_tile.resize(old_size + tinj.num_parts);
+    ParticleType* pstruct = &(particle_tile.GetArrayOfStructs()[0]);
+#ifdef USE_SPRAY_SOA
+    GpuArray<Real*, NAR_SPR> rdata;
+    for (int n = 0; n < NAR_SPR; ++n)
+      rdata[n] = particle_tile.GetStructOfArrays().GetRealData(n).data();
+#endif
+    const int jindx = tinj.jindx;
+    const SprayJetSample js = jet_samples[jindx];
+    const int* parcels = tile_parcels.data() + tinj.start;
+    const Long pid_start = pid;
+    amrex::ParallelFor(
+      tinj.num_parts, [=] AMREX_GPU_DEVICE(Long i) noexcept {
+        const int n = parcels[i];
+        SprayRandom rng(n, jindx, time, spray_rng_inject);
+        // Sample a location on the jet inlet
+        Real loc1 = 0.;
+        Real loc2 = 0.;
+        sprayJetInlet(js, rng, loc1, loc2);
+        const Long pindx = old_size + i;
+        ParticleType& p = pstruct[pindx];
+        p.id() = pid_start + i;
+        p.cpu() = my_proc;
+        p.idata(SPRAY_KEY_COMP) =
+          sprayParticleKey(n, jindx, time, spray_key_inject);
+        const Real theta = js.spray_angle * (rng.uniform() - 0.5);
+#if AMREX_SPACEDIM == 3
+        const Real theta2 = 2. * M_PI * rng.uniform();
+#else
+        const Real theta2 = 0.;
+#endif
+        const Real sint = std::sin(theta);
+        const Real cost = std::cos(theta);
+        const Real cost2 = std::cos(theta2);
+        const Real sint2 = std::sin(theta2);
+        // Use a log normal distribution
+        const Real cur_dia = std::exp(rng.normal(js.log_mean, js.log_stdev));
+        // Add particles as if they have advanced some random portion of dt
+        const Real pmov = rng.uniform();
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+          const Real vel =
+            js.jet_vel * (cost * js.norm[dir] +
+                          sint * (cost2 * js.t1[dir] + sint2 * js.t2[dir]));
+          p.pos(dir) = js.cent[dir] + loc1 * js.t1[dir] + loc2 * js.t2[dir] +
+                       pmov * dt * vel;
+#ifdef USE_SPRAY_SOA
+          rdata[SPI.pstateVel + dir][pindx] = vel;
+#else
+          p.rdata(SPI.pstateVel + dir) = vel;
+#endif
+        }
+#ifdef USE_SPRAY_SOA
+        rdata[SPI.pstateT][pindx] = js.part_temp;
+        rdata[SPI.pstateDia][pindx] = cur_dia;
+        for (int sp = 0; sp < SPRAY_FUEL_NUM; ++sp)
+          rdata[SPI.pstateY + sp][pindx] = js.Y_jet[sp];
+#else
+        p.rdata(SPI.pstateT) = js.part_temp;
+        p.rdata(SPI.pstateDia) = cur_dia;
+        for (int sp = 0; sp < SPRAY_FUEL_NUM; ++sp)
+          p.rdata(SPI.pstateY + sp) = js.Y_jet[sp];
+#endif
+      });
+    pid += tinj.num_parts;
+  }
+  Gpu::streamSynchronize();
+  // Redistribute is done outside of this function
+  return true;
+}
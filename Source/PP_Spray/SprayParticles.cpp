@@ -1,5 +1,6 @@
 
 #include "SprayParticles.H"
+#include <AMReX_ParmParse.H>
 #include <AMReX_ParticleReduce.H>
 #include <AMReX_Particles.H>
 #ifdef SPRAY_PELE_LM
@@ -36,6 +37,39 @@ SprayParticleContainer::init_bcs()
   }
 }
 
+void
+SprayParticleContainer::readSprayParams()
+{
+  ParmParse pp("particles");
+  pp.query("init_binary_file", m_initBinaryFile);
+  pp.query("use_collision_model", m_sprayCollision);
+  pp.query("snapshot_format", m_snapshotFormat);
+  if (m_snapshotFormat != "binary" && m_snapshotFormat != "ascii")
+    Abort("particles.snapshot_format must be binary or ascii");
+  pp.query("snapshot_nwriters", m_snapshotWriters);
+  pp.query("snapshot_compress", m_snapshotCompress);
+  pp.query("async_io", m_asyncIO);
+  pp.query("plot_every", m_plotSelect.every);
+  if (m_plotSelect.every < 1)
+    Abort("particles.plot_every must be at least 1");
+  if (pp.contains("plot_region_lo") || pp.contains("plot_region_hi")) {
+    Vector<Real> region_lo(AMREX_SPACEDIM);
+    Vector<Real> region_hi(AMREX_SPACEDIM);
+    pp.getarr("plot_region_lo", region_lo, 0, AMREX_SPACEDIM);
+    pp.getarr("plot_region_hi", region_hi, 0, AMREX_SPACEDIM);
+    m_plotSelect.use_region = true;
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      m_plotSelect.region_lo[dir] = region_lo[dir];
+      m_plotSelect.region_hi[dir] = region_hi[dir];
+    }
+  }
+  pp.queryarr("plot_vars", m_plotVars);
+  pp.query("plot_single_precision", m_plotSingle);
+#ifdef AMREX_USE_EB
+  pp.query("eb_redist_vfrac", m_EBRedistVFrac);
+#endif
+}
+
 void
 SprayParticleContainer::moveKick(
   MultiFab& state,
@@ -82,6 +116,10 @@ SprayParticleContainer::moveKickDrift(
 
   bool isActive = (isVirtualPart || isGhostPart) ? false : true;
 
+  // Collide droplets before they are moved, while they are within their tiles
+  if (m_sprayCollision && isActive && do_move)
+    sprayCollision(level, dt, time);
+
   BL_PROFILE_VAR("SprayParticles::updateParticles()", UPD_PART);
   updateParticles(
     level, state, source, dt, time, state_ghosts, source_ghosts, isActive,
@@ -192,6 +230,9 @@ SprayParticleContainer::updateParticles(
   const auto bndryarea = &(factory.getBndryArea());
   const auto bndrynorm = &(factory.getBndryNormal());
   const auto volfrac = &(factory.getVolFrac());
+  buildEBInterpData(level, state);
+  const iMultiFab& ebmaskmf = *m_EBStencilMask[level];
+  const EBGeomLayout& ebgeomlayout = *m_EBInterpGeom[level];
 #endif
   IntVect bndry_lo; // Designation for boundary types
   IntVect bndry_hi; // 0 - Periodic, 1 - Reflective, -1 - Non-reflective
@@ -243,6 +284,8 @@ SprayParticleContainer::updateParticles(
     Array4<const Real> barea_fab;
     Array4<const Real> volfrac_fab;
     const auto& flags_array = flags.array();
+    Array4<const int> const& ebmask = ebmaskmf.const_array(pti);
+    const EBInterpGeom* ebgeom = ebgeomlayout[pti].data();
     if (flags.getType(state_box) == FabType::regular) {
       eb_in_box = false;
     } else {
@@ -263,10 +306,11 @@ SprayParticleContainer::updateParticles(
     //       umac{AMREX_D_DECL(u_mac[0].array(pti), u_mac[1].array(pti),
     //       u_mac[2].array(pti))};
     // #endif
-    amrex::ParallelForRNG(
+    const Real cur_time = time;
+    amrex::ParallelFor(
       Np, [pstruct, statearr, sourcearr, plo, phi, dx, dxi, do_move, SPI, fdat,
            src_box, state_box, bndry_hi, bndry_lo, flow_dt, inv_vol, ltransparm,
-           at_bounds, wallT, isActive
+           at_bounds, wallT, isActive, cur_time
 #ifdef USE_SPRAY_SOA
            ,
            attribs
@@ -274,9 +318,9 @@ SprayParticleContainer::updateParticles(
 #ifdef AMREX_USE_EB
            ,
            flags_array, ccent_fab, bcent_fab, bnorm_fab, barea_fab, volfrac_fab,
-           eb_in_box
+           ebmask, ebgeom, eb_in_box
 #endif
-    ] AMREX_GPU_DEVICE(int pid, amrex::RandomEngine const& engine) noexcept {
+    ] AMREX_GPU_DEVICE(int pid) noexcept {
         auto eos = pele::physics::PhysicsType::eos();
         SprayUnits SPU;
         GpuArray<Real, NUM_SPECIES> mw_fluid;
@@ -293,10 +337,16 @@ SprayParticleContainer::updateParticles(
             indx_array; // Array of adjacent cells
           GpuArray<Real, AMREX_D_PICK(2, 4, 8)>
             weights; // Array of corresponding weights
-          RealVect lx = (p.pos() - plo) * dxi + 0.5;
-          IntVect ijk = lx.floor(); // Upper cell center
           RealVect lxc = (p.pos() - plo) * dxi;
           IntVect ijkc = lxc.floor(); // Cell with particle
+          RealVect lx = lxc + 0.5;
+          IntVect ijk = lx.floor(); // Upper cell center
+#ifdef AMREX_USE_EB
+          // Upper cell center before any shift from the domain boundaries
+          const IntVect ijkn = ijk;
+          // Position before moving, used to find intersections with the EB
+          const RealVect pos_prev = p.pos();
+#endif
           bool is_wall_film = false;
           Real face_area = 0.;
           IntVect bflags(IntVect::TheZeroVector());
@@ -318,54 +368,32 @@ SprayParticleContainer::updateParticles(
           // Length from cell center to boundary face center
           Real diff_cent = 0.5 * dx[0];
           bool do_fe_interp = false;
+          // Check for wall impingement on the EB after moving
+          bool check_eb = false;
 #ifdef AMREX_USE_EB
-          do_fe_interp = true;
-          // Cell containing particle centroid
-          AMREX_D_TERM(const int ip = static_cast<int>(
-                         amrex::Math::floor((p.pos(0) - plo[0]) * dxi[0]));
-                       , const int jp = static_cast<int>(
-                           amrex::Math::floor((p.pos(1) - plo[1]) * dxi[1]));
-                       , const int kp = static_cast<int>(
-                           amrex::Math::floor((p.pos(2) - plo[2]) * dxi[2])););
-          AMREX_D_TERM(const int i = static_cast<int>(amrex::Math::floor(
-                         (p.pos(0) - plo[0]) * dxi[0] + 0.5));
-                       , const int j = static_cast<int>(amrex::Math::floor(
-                           (p.pos(1) - plo[1]) * dxi[1] + 0.5));
-                       , const int k = static_cast<int>(amrex::Math::floor(
-                           (p.pos(2) - plo[2]) * dxi[2] + 0.5)););
-          if (!eb_in_box) {
-            do_fe_interp = false;
-          } else {
-            // All cells in the stencil are regular. Use
-            // traditional trilinear interpolation
-            if (
-              flags_array(i - 1, j - 1, k - 1).isRegular() and
-              flags_array(i, j - 1, k - 1).isRegular() and
-              flags_array(i - 1, j, k - 1).isRegular() and
-              flags_array(i, j, k - 1).isRegular() and
-              flags_array(i - 1, j - 1, k).isRegular() and
-              flags_array(i, j - 1, k).isRegular() and
-              flags_array(i - 1, j, k).isRegular() and
-              flags_array(i, j, k).isRegular())
-              do_fe_interp = false;
-          }
+          check_eb = eb_in_box;
+          // If all cells in the stencil are regular, use
+          // traditional trilinear interpolation
+          if (eb_in_box)
+            do_fe_interp = !eb_mask_test(ebmask(ijkn), eb_regular_stencil);
           if (do_fe_interp) {
             fe_interp(
-              p.pos(), ip, jp, kp, dx, dxi, plo, flags_array, ccent_fab,
-              bcent_fab, bnorm_fab, volfrac_fab, indx_array.data(),
+              p.pos(), ijkc, dxi, plo, ebmask, ebgeom, indx_array.data(),
               weights.data());
           } else {
             trilinear_interp(
               ijk, lx, indx_array.data(), weights.data(), bflags);
           }
           bool eb_wall_film = false;
-          if (is_wall_film && flags_array(ip, jp, kp).isSingleValued()) {
+          if (
+            is_wall_film && eb_in_box &&
+            eb_mask_test(ebmask(ijkc), eb_cut_cell)) {
             eb_wall_film = true;
-            face_area = barea_fab(ip, jp, kp);
+            face_area = barea_fab(ijkc);
             diff_cent = 0.;
             for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
-              diff_cent += std::pow(
-                bcent_fab(ip, jp, kp, dir) - ccent_fab(ip, jp, kp, dir), 2);
+              diff_cent +=
+                std::pow(bcent_fab(ijkc, dir) - ccent_fab(ijkc, dir), 2);
             diff_cent = std::sqrt(diff_cent);
           }
 #else
@@ -479,8 +507,7 @@ SprayParticleContainer::updateParticles(
               cur_coef * gpv.fluid_eng_src);
           }
           // Solve for splash model/wall film formation
-          if ((at_bounds || do_fe_interp) && do_move) {
-            IntVect ijkc_prev = ijkc;
+          if ((at_bounds || check_eb) && do_move) {
             lx = (p.pos() - plo) * dxi + 0.5;
             ijk = lx.floor();
             lxc = (p.pos() - plo) * dxi;
@@ -500,9 +527,9 @@ SprayParticleContainer::updateParticles(
               p.id() = -1;
             } else {
               bool wall_check = check_wall(
-                p, bflags, ijkc, ijkc_prev,
+                p.pos(), bflags,
 #ifdef AMREX_USE_EB
-                eb_in_box, flags_array, bcent_fab, bnorm_fab,
+                eb_in_box, pos_prev, plo, dx, dxi, ebmask, ebgeom,
 #endif
                 bloc, normal, bcentv);
               if (wall_check) {
@@ -512,9 +539,11 @@ SprayParticleContainer::updateParticles(
                   SPRF.pos_refl = p.pos();
                   for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf)
                     SPRF.Y_refl[spf] = p.rdata(SPI.pstateY + spf);
+                  SprayRandom rng(
+                    p.idata(SPRAY_KEY_COMP), 0, cur_time, spray_rng_wall);
                   splash_flag = impose_wall(
                     p, SPI, *fdat, dx, plo, phi, wallT, bloc, normal, bcentv,
-                    SPRF, isActive, dry_wall, engine);
+                    SPRF, isActive, dry_wall, rng);
                 }
               } // if (wall_check)
             }   // if (left_dom)
@@ -114,10 +114,14 @@ SprayParticleContainer::wallImpingement(
             //               isActive, dry_wall);
             // Only add active particles, not ghost or virtual
             if (SPRF.Ns_refl > 0 && isActive) {
+              // Adding particles can move p, so keep the key of the parent
+              const int parent_key = p.idata(SPRAY_KEY_COMP);
               for (int nsp = 0; nsp < SPRF.Ns_refl; ++nsp) {
                 ParticleType pnew;
                 pnew.id() = ParticleType::NextID();
                 pnew.cpu() = ParallelDescriptor::MyProc();
+                pnew.idata(SPRAY_KEY_COMP) =
+                  sprayParticleKey(parent_key, nsp, time, spray_key_splash);
                 pnew.rdata(SPI.pstateDia) = SPRF.dia_refl;
                 pnew.rdata(SPI.pstateT) = T_part;
                 for (int spf = 0; spf < SPRAY_FUEL_NUM; ++spf)
@@ -126,7 +130,9 @@ SprayParticleContainer::wallImpingement(
                   pnew.rdata(SPI.pstateVel + dir) = 0.;
                   pnew.pos(dir) = SPRF.pos_refl[dir];
                 }
-                create_splash_droplet(pnew, SPI, SPRF, SPU);
+                SprayRandom rng(
+                  pnew.idata(SPRAY_KEY_COMP), 0, time, spray_rng_splash);
+                create_splash_droplet(pnew, SPI, SPRF, SPU, rng);
                 ptile.push_back(pnew);
               }
             } // if (Ns_refl > 0)
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Convert ASCII spray particle files to the binary columnar format.
+
+The ASCII format is the one read with particles.init_file: the first line
+is the number of particles and each following line holds the particle
+position followed by the velocity, temperature, diameter and fuel mass
+fractions. The binary format is described in SprayBinaryIO.H and is read
+in parallel with particles.init_binary_file.
+"""
+
+import argparse
+import struct
+import sys
+from array import array
+
+MAGIC = b"PMPSPRAY"
+VERSION = 1
+CODEC_RAW = 0
+
+
+def component_names(dim, ncomp, fuel_names):
+    """Names of the real components in the order stored on the particles."""
+    names = ["xvel", "yvel", "zvel"][:dim] + ["temperature", "diam"]
+    nfuel = ncomp - len(names)
+    if nfuel < 1:
+        sys.exit("Too few components for dimension {}".format(dim))
+    if fuel_names is None:
+        fuel_names = ["fuel{}".format(sp) for sp in range(nfuel)]
+    if len(fuel_names) != nfuel:
+        sys.exit("Expected {} fuel names".format(nfuel))
+    return names + ["spray_mf_" + name for name in fuel_names]
+
+
+def read_ascii(fname, dim):
+    """Read the ASCII file and return a list of columns."""
+    with open(fname, "r") as infile:
+        nparts = int(infile.readline().split()[0])
+        columns = None
+        for lnum in range(nparts):
+            vals = [float(v) for v in infile.readline().split()]
+            if columns is None:
+                if len(vals) <= dim:
+                    sys.exit("Line {} has too few values".format(lnum + 2))
+                columns = [array("d") for _ in vals]
+            if len(vals) != len(columns):
+                sys.exit("Line {} has the wrong number of values".format(lnum + 2))
+            for col, val in zip(columns, vals):
+                col.append(val)
+    if columns is None:
+        sys.exit("No particles found in {}".format(fname))
+    return columns
+
+
+def write_binary(fname, dim, names, columns, chunk_size):
+    """Write the columns in chunks of chunk_size particles."""
+    nparts = len(columns[0])
+    ncols = len(columns)
+    ncomp = ncols - dim
+    chunks = []
+    start = 0
+    while start < nparts:
+        count = min(chunk_size, nparts - start)
+        chunks.append((start, count))
+        start += count
+    # Header size, see sprayFileHeaderSize
+    hsize = len(MAGIC) + 4 * 4 + 2 * 8
+    hsize += sum(4 + len(name.encode()) for name in names)
+    hsize += len(chunks) * (8 + ncols * (2 * 8 + 4))
+    with open(fname, "wb") as outfile:
+        outfile.write(MAGIC)
+        outfile.write(struct.pack("=iiiiqq", VERSION, dim, ncomp, 0, nparts, len(chunks)))
+        for name in names:
+            bname = name.encode()
+            outfile.write(struct.pack("=i", len(bname)))
+            outfile.write(bname)
+        offset = hsize
+        for start, count in chunks:
+            outfile.write(struct.pack("=q", count))
+            for _ in range(ncols):
+                nbytes = 8 * count
+                outfile.write(struct.pack("=qqi", offset, nbytes, CODEC_RAW))
+                offset += nbytes
+        for start, count in chunks:
+            for col in columns:
+                col[start : start + count].tofile(outfile)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("input", help="ASCII spray particle file")
+    parser.add_argument("output", help="binary spray particle file")
+    parser.add_argument("--dim", type=int, default=3, choices=[2, 3])
+    parser.add_argument(
+        "--fuel-names", nargs="+", default=None, help="names of the fuel species"
+    )
+    parser.add_argument(
+        "--chunk-size",
+        type=int,
+        default=1 << 20,
+        help="number of particles in each chunk",
+    )
+    args = parser.parse_args()
+    columns = read_ascii(args.input, args.dim)
+    names = component_names(args.dim, len(columns) - args.dim, args.fuel_names)
+    write_binary(args.output, args.dim, names, columns, max(args.chunk_size, 1))
+    print("Wrote {} particles to {}".format(len(columns[0]), args.output))
+
+
+if __name__ == "__main__":
+    main()
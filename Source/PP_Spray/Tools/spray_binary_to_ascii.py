@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Read binary columnar spray particle files.
+
+Binary files are written with checkpoints when particles.snapshot_format is
+binary, the format is described in SprayBinaryIO.H. read_spray_binary can be
+imported by post-processing scripts. When run as a script, the particles are
+written in the ASCII format read with particles.init_file, with the position
+followed by the real components on each line.
+"""
+
+import argparse
+import struct
+import sys
+from array import array
+
+MAGIC = b"PMPSPRAY"
+VERSION = 1
+CODEC_RAW = 0
+CODEC_SHUFFLE_RLE = 1
+FLAG_SINGLE = 1
+
+
+def _unpack(infile, fmt):
+    size = struct.calcsize(fmt)
+    data = infile.read(size)
+    if len(data) != size:
+        sys.exit("Unexpected end of file")
+    return struct.unpack(fmt, data)
+
+
+def decode_shuffle_rle(data, count, vsize):
+    """Undo the run length encoding and byte shuffle of a column."""
+    shuffled = bytearray()
+    i = 0
+    while i < len(data):
+        ctrl = struct.unpack("=b", data[i : i + 1])[0]
+        i += 1
+        if ctrl >= 0:
+            shuffled += data[i : i + ctrl + 1]
+            i += ctrl + 1
+        else:
+            shuffled += data[i : i + 1] * (1 - ctrl)
+            i += 1
+    if len(shuffled) != count * vsize:
+        sys.exit("Binary spray file column is corrupt")
+    raw = bytearray(count * vsize)
+    for k in range(vsize):
+        raw[k::vsize] = shuffled[k * count : (k + 1) * count]
+    return bytes(raw)
+
+
+def read_spray_header(infile):
+    """Read the header and chunk table, returns a dictionary."""
+    if infile.read(len(MAGIC)) != MAGIC:
+        sys.exit("Not a binary spray particle file")
+    version, dim, ncomp, flags, nparts, nchunks = _unpack(infile, "=iiiiqq")
+    if version > VERSION:
+        sys.exit("Unsupported binary spray file version {}".format(version))
+    names = []
+    for _ in range(ncomp):
+        (length,) = _unpack(infile, "=i")
+        names.append(infile.read(length).decode())
+    ncols = dim + ncomp
+    chunks = []
+    for _ in range(nchunks):
+        (count,) = _unpack(infile, "=q")
+        cols = [_unpack(infile, "=qqi") for _ in range(ncols)]
+        chunks.append((count, cols))
+    return {
+        "dim": dim,
+        "flags": flags,
+        "nparticles": nparts,
+        "names": names,
+        "chunks": chunks,
+    }
+
+
+def read_spray_binary(fname):
+    """Read a binary spray file.
+
+    Returns the header and a list of columns, the position directions
+    followed by the real components named in header["names"].
+    """
+    with open(fname, "rb") as infile:
+        hdr = read_spray_header(infile)
+        ncols = hdr["dim"] + len(hdr["names"])
+        columns = [array("d") for _ in range(ncols)]
+        vtype = "f" if hdr["flags"] & FLAG_SINGLE else "d"
+        vsize = array(vtype).itemsize
+        for count, cols in hdr["chunks"]:
+            for col, (offset, nbytes, codec) in zip(columns, cols):
+                infile.seek(offset)
+                data = infile.read(nbytes)
+                if codec == CODEC_SHUFFLE_RLE:
+                    data = decode_shuffle_rle(data, count, vsize)
+                elif codec != CODEC_RAW:
+                    sys.exit("Unsupported codec {}".format(codec))
+                vals = array(vtype)
+                vals.frombytes(data)
+                col.extend(vals)
+    return hdr, columns
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("input", help="binary spray particle file")
+    parser.add_argument("output", nargs="?", help="ASCII spray particle file")
+    parser.add_argument(
+        "--info", action="store_true", help="only print the file header"
+    )
+    args = parser.parse_args()
+    if args.info:
+        with open(args.input, "rb") as infile:
+            hdr = read_spray_header(infile)
+        print("dimension: {}".format(hdr["dim"]))
+        print("particles: {}".format(hdr["nparticles"]))
+        print("chunks: {}".format(len(hdr["chunks"])))
+        print("single precision: {}".format(bool(hdr["flags"] & FLAG_SINGLE)))
+        print("components: {}".format(" ".join(hdr["names"])))
+        return
+    if args.output is None:
+        sys.exit("An output file is required")
+    hdr, columns = read_spray_binary(args.input)
+    with open(args.output, "w") as outfile:
+        outfile.write("{}\n".format(hdr["nparticles"]))
+        for vals in zip(*columns):
+            outfile.write(" ".join(repr(v) for v in vals) + "\n")
+    print("Wrote {} particles to {}".format(hdr["nparticles"], args.output))
+
+
+if __name__ == "__main__":
+    main()
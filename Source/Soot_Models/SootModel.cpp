@@ -28,6 +28,159 @@ the_same_box(const amrex::Box& b)
   return b;
 }
 
+// Check if soot chemistry happens in a cell, which needs a temperature above
+// the cutoff and either soot or the PAH inception species
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE bool
+sootCellActive(
+  const int i,
+  const int j,
+  const int k,
+  Array4<const Real> const& Qstate,
+  const int qRhoIndx,
+  const int qTempIndx,
+  const int qPAHIndx,
+  const int qSootIndx,
+  const Real invMwPAH,
+  const Real Tcutoff,
+  const Real Xcutoff)
+{
+  constexpr SootConst sc{};
+  if (Qstate(i, j, k, qTempIndx) <= Tcutoff)
+    return false;
+  // The moment M10 is the soot volume fraction
+  if (Qstate(i, j, k, qSootIndx + 1) > sc.fvCutoff)
+    return true;
+#ifdef SOOT_PELE_LM
+  const Real rhoPAH = Qstate(i, j, k, qPAHIndx) * sc.rho_conv;
+#else
+  const Real rhoPAH =
+    Qstate(i, j, k, qRhoIndx) * sc.rho_conv * Qstate(i, j, k, qPAHIndx);
+#endif
+  return rhoPAH * invMwPAH > Xcutoff;
+}
+
+// Time step that limits the change of the gas species mass fractions from
+// the surface reactions to maxDtRate, rho_Y and mw are for the soot gas
+// species
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE Real
+sootStableDt(
+  const Real rho,
+  const Real rho_Y[],
+  const Real mw[],
+  const Real omega_src[],
+  const Real maxDtRate)
+{
+  Real rho_src = 0.;
+  for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+    rho_src += omega_src[sp] * mw[sp];
+  }
+  Real maxrate = 0.;
+  for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+    Real Y_n = rho_Y[sp] / rho;
+    Real omegai = omega_src[sp] * mw[sp];
+    Real newrate =
+      (std::abs(omegai - Y_n * rho_src) - maxDtRate * rho_src) /
+      (maxDtRate * rho);
+    if (newrate > maxrate) {
+      maxrate = newrate;
+    }
+  }
+  return 1. / (maxrate + 1.E-12);
+}
+
+// State of a cell at the start of the soot integration
+struct SootCellInit
+{
+  Real rho0;
+  Real T;
+  // Dynamic viscosity
+  Real mu;
+  // Average molar mass (g/mol)
+  Real molarMass;
+  // Initial mass concentrations (g/cm^3)
+  GpuArray<Real, NUM_SOOT_GS> rho_Y;
+  // Molar concentrations (mol/cm^3)
+  GpuArray<Real, NUM_SOOT_GS> xi_n;
+  // Moments M00, M10, M01,..., N0 in mol of C
+  GpuArray<Real, NUM_SOOT_MOMENTS + 1> moments;
+};
+
+// Read the state of cell (i, j, k) used by the soot integration
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+readSootCell(
+  const int i,
+  const int j,
+  const int k,
+  Array4<const Real> const& Qstate,
+  Array4<const Real> const& coeff_mu,
+  const SootData* sd,
+  const int qRhoIndx,
+  const int qTempIndx,
+  const int qSpecIndx,
+  const int qSootIndx,
+  SootCellInit& ci)
+{
+  constexpr SootConst sc{};
+  const Real rho = Qstate(i, j, k, qRhoIndx) * sc.rho_conv;
+  ci.rho0 = rho;
+  ci.T = Qstate(i, j, k, qTempIndx);
+  ci.mu = coeff_mu(i, j, k) * sc.mu_conv;
+  // Compute the average molar mass (g/mol)
+  Real molarMass = 0.;
+  for (int sp = 0; sp < NUM_SPECIES; ++sp) {
+    const int peleIndx = qSpecIndx + sp;
+    // State provided by PeleLM is the concentration, rhoY
+#ifdef SOOT_PELE_LM
+    const Real rhoYsp =
+      amrex::max(0., Qstate(i, j, k, peleIndx) * sc.rho_conv);
+#else
+    const Real rhoYsp = amrex::max(0., rho * Qstate(i, j, k, peleIndx));
+#endif
+    molarMass += rhoYsp * sd->invMW[sp];
+  }
+  ci.molarMass = rho / molarMass;
+  // Extract mass fractions for gas phases corresponding to GasSpecIndx
+  for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+    const int peleIndx = qSpecIndx + sd->refIndx[sp];
+#ifdef SOOT_PELE_LM
+    ci.rho_Y[sp] = amrex::max(0., Qstate(i, j, k, peleIndx) * sc.rho_conv);
+#else
+    ci.rho_Y[sp] = amrex::max(0., rho * Qstate(i, j, k, peleIndx));
+#endif
+    ci.xi_n[sp] = ci.rho_Y[sp] / sd->mwGS[sp];
+  }
+  // Extract moment values
+  for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom)
+    ci.moments[mom] = Qstate(i, j, k, qSootIndx + mom);
+  // Convert moments from CGS to mol of C
+  sd->convertToMol(ci.moments.data());
+}
+
+// Values of a cell held fixed while its soot sources are integrated, the
+// surface reaction rate constants are stored in k_fwd and k_bkwd
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE SootCellConst
+sootCellConst(
+  const SootCellInit& ci,
+  const SootReaction* sr,
+  const Real betaNF,
+  Real k_fwd[],
+  Real k_bkwd[])
+{
+  constexpr SootConst sc{};
+  // (R*T*Pi/(2*A*rho_soot))^(1/2)
+  const Real convT = std::sqrt(sc.colFact * ci.T);
+  // Constant for free molecular collisions
+  const Real colConst =
+    convT * sc.colFactPi23 * sc.colFact16 * pele::physics::Constants::Avna;
+  // Collision frequency between two dimer in the free
+  // molecular regime with van der Waals enhancement
+  // Units: cm^3/mol-s
+  const Real betaNucl = convT * betaNF;
+  // Surface reaction rate constants, temperature is fixed while subcycling
+  sr->rateConstants(ci.T, k_fwd, k_bkwd);
+  return {ci.T, convT, colConst, betaNucl, ci.mu, ci.molarMass, k_fwd, k_bkwd};
+}
+
 // Default constructor
 SootModel::SootModel()
   : m_sootVerbosity(0),
@@ -45,6 +198,7 @@ SootModel::SootModel()
     m_maxDtRate(-1.),
     m_Tcutoff(-1.),
     m_numSubcycles(2),
+    m_sootIntegrator(sootIntegExplicit),
     m_reactDataFilled(false),
     m_gasSpecNames(NUM_SOOT_GS, "")
 {
@@ -133,6 +287,16 @@ SootModel::define()
     }
   }
 
+  // Molecular weights, so the source kernels do not evaluate them per cell
+  {
+    auto eos = pele::physics::PhysicsType::eos();
+    GpuArray<Real, NUM_SPECIES> mw_fluidF;
+    eos.molecular_weight(mw_fluidF.data());
+    eos.inv_molecular_weight(m_sootData->invMW.data());
+    for (int sootSpec = 0; sootSpec < ngs; ++sootSpec)
+      m_sootData->mwGS[sootSpec] = mw_fluidF[m_sootData->refIndx[sootSpec]];
+  }
+
   // Assign moment factor member data
   defineMemberData(dimerVol);
   // From SootModel_react.cpp
@@ -175,9 +339,30 @@ SootModel::readSootParams()
   m_numSubcycles = 10;
 #endif
   pp.query("num_subcycles", m_numSubcycles);
+  // Integrator for the stiff soot sources, explicit subcycles or adaptive
+  // Rosenbrock steps, which start from the subcycle size
+  std::string integrator = "explicit";
+  pp.query("integrator", integrator);
+  if (integrator == "explicit") {
+    m_sootIntegrator = sootIntegExplicit;
+  } else if (integrator == "rosenbrock") {
+    m_sootIntegrator = sootIntegRosenbrock;
+  } else {
+    Abort("soot.integrator must be explicit or rosenbrock");
+  }
+  pp.query("rosenbrock_rtol", m_rosParams.rtol);
+  pp.query("rosenbrock_max_steps", m_rosParams.maxSteps);
+  if (m_rosParams.rtol <= 0. || m_rosParams.maxSteps < 1)
+    Abort("soot.rosenbrock_rtol and soot.rosenbrock_max_steps must be > 0");
   // Determines if mass is conserved by adding lost mass to H2
   m_conserveMass = false;
   pp.query("conserve_mass", m_conserveMass);
+#ifdef SOOT_PELE_LM
+  // Relative change of the state that refreshes the soot source across SDC
+  // iterations, the source is recomputed every iteration if not positive
+  m_sdcLagTol = 0.;
+  pp.query("sdc_lag_tol", m_sdcLagTol);
+#endif
   m_readSootParams = true;
 }
 
@@ -189,11 +374,13 @@ SootModel::defineMemberData(const Real dimerVol)
     Print() << "SootModel::defineMemberData(): Defining member data"
             << std::endl;
   }
-  SootConst sc;
+  constexpr SootConst sc{};
   Real nuclVol = 2. * dimerVol;
   Real nuclSurf = std::pow(nuclVol, 2. / 3.);
   m_sootData->nuclVol = nuclVol;
   m_sootData->nuclSurf = nuclSurf;
+  m_sootData->lnNuclVol = std::log(nuclVol);
+  m_sootData->lnNuclSurf = std::log(nuclSurf);
   // Compute V_nucl and V_dimer to fractional powers
   for (int i = 0; i < 9; ++i) {
     Real exponent = 2. * (Real)i - 3.;
@@ -254,9 +441,46 @@ SootModel::defineMemberData(const Real dimerVol)
   m_sootData->condFact =
     std::sqrt((1. / nuclVol) + (1. / dimerVol)) *
     std::pow((std::pow(nuclVol, 1. / 3.) + std::pow(dimerVol, 1. / 3.)), 2.);
+  defineFracMomPlan();
   m_memberDataDefined = true;
 }
 
+// Record the fractional moments requested by each source term and the
+// distinct fractional moments of each term, so each is only evaluated once
+// per term and subcycle
+void
+SootModel::defineFracMomPlan()
+{
+  SootData* sd = m_sootData;
+  sd->fmPlan = SootFracMomPlan{};
+  SootFracMomRecord rec{&sd->fmPlan};
+  // The requests do not depend on the values passed to the source terms
+  Real mom_src[NUM_SOOT_MOMENTS + 1] = {0.};
+  const Real dimerRate = 1.;
+  sd->dimerization(1., 1., dimerRate, rec);
+  sd->condensationMomSrc(1., 1., rec, mom_src);
+  sd->coagulationMomSrc(1., 1., 1., 1., 1., rec, mom_src);
+  sd->surfaceArea(rec);
+  sd->surfaceGrowthMomSrc(1., rec, mom_src);
+  sd->oxidFragMomSrc(1., 1., rec, mom_src);
+  for (int ord = 0; ord < sd->fmPlan.numOrders; ++ord) {
+    sd->fmPlan.nuclFact[ord] =
+      std::pow(sd->nuclVol, sd->fmPlan.volOrd[ord]) *
+      std::pow(sd->nuclSurf, sd->fmPlan.surfOrd[ord]);
+  }
+  if (m_sootVerbosity) {
+    int maxSlots = 0;
+    for (int term = 0; term < numFracMomTerms; ++term)
+      maxSlots = amrex::max(maxSlots, sd->fmPlan.termSlots[term]);
+    Print() << "SootModel::defineFracMomPlan(): " << sd->fmPlan.numCalls
+            << " fractional moments with " << sd->fmPlan.numOrders
+            << " distinct orders, std::exp calls per cell and subcycle "
+            << "reduced from " << rec.numExp << " to "
+            << sd->fmPlan.numSlots << ", at most " << maxSlots
+            << " cached per cell" << std::endl;
+  }
+}
+
 // Add derive plot variables
 void
 SootModel::addSootDerivePlotVars(
@@ -296,15 +520,28 @@ SootModel::addSootSourceTerm(
   Array4<const Real> const& coeff_mu,
   Array4<Real> const& soot_state,
   const Real time,
-  const Real dt) const
+  const Real dt,
+  Real* soot_dt) const
+{
+  BL_PROFILE("SootModel::addSootSourceTerm");
+  addSootSourceCells(
+    vbox, Qstate, coeff_mu, soot_state, Array4<const Real>{}, dt, soot_dt);
+}
+
+// Add soot source term to the cells of vbox with soot chemistry, and if
+// cellFlag is defined, only where its first component is positive
+void
+SootModel::addSootSourceCells(
+  const Box& vbox,
+  Array4<const Real> const& Qstate,
+  Array4<const Real> const& coeff_mu,
+  Array4<Real> const& soot_state,
+  Array4<const Real> const& cellFlag,
+  const Real dt,
+  Real* soot_dt) const
 {
   AMREX_ASSERT(m_memberDataDefined);
   AMREX_ASSERT(m_setIndx);
-  BL_PROFILE("SootModel::addSootSourceTerm");
-  if (m_sootVerbosity && ParallelDescriptor::IOProcessor()) {
-    Print() << "SootModel::addSootSourceTerm(): Adding soot source term to "
-            << vbox << std::endl;
-  }
   const int nsub_init = m_numSubcycles;
   // Primitive components
   const int qRhoIndx = m_sootIndx.qRhoIndx;
@@ -320,181 +557,342 @@ SootModel::addSootSourceTerm(
   const bool conserveMass = m_conserveMass;
   const Real Tcutoff = m_Tcutoff;
   const Real Xcutoff = 1.E-12;
+  const bool useRosenbrock = (m_sootIntegrator == sootIntegRosenbrock);
+  SootRosParams rosParams = m_rosParams;
+  rosParams.xiTol = Xcutoff;
+  // Estimate the stable time step from the sources at the start
+  const bool estimateDt = (soot_dt != nullptr);
+  const Real maxDtRate = m_maxDtRate;
 
   // H2 absorbs the error from surface reactions
   const int absorbIndx = SootGasSpecIndx::indxH2;
-  const int absorbIndxN = m_sootData->refIndx[absorbIndx];
-  const int absorbIndxP = specIndx + absorbIndxN;
+
+  // Compact the cells with soot chemistry, which in flames are usually a
+  // thin sheet, and skip boxes without any
+  const int qPAHIndx = qSpecIndx + m_PAHindx;
+  const Real invMwPAH = 1. / m_sootData->mwGS[SootGasSpecIndx::indxPAH];
+  const Dim3 lo = amrex::lbound(vbox);
+  const Dim3 len = amrex::length(vbox);
+  const int npts = static_cast<int>(vbox.numPts());
+  const bool useFlag = static_cast<bool>(cellFlag);
+  Gpu::DeviceVector<int> activeCells(npts);
+  int* activePtr = activeCells.data();
+  const int nactive = Scan::PrefixSum<int>(
+    npts,
+    [=] AMREX_GPU_DEVICE(int n) -> int {
+      const int k = n / (len.x * len.y) + lo.z;
+      const int j = (n / len.x) % len.y + lo.y;
+      const int i = n % len.x + lo.x;
+      if (useFlag && cellFlag(i, j, k) <= 0.)
+        return 0;
+      return sootCellActive(
+        i, j, k, Qstate, qRhoIndx, qTempIndx, qPAHIndx, qSootIndx, invMwPAH,
+        Tcutoff, Xcutoff);
+    },
+    [=] AMREX_GPU_DEVICE(int n, int const& s) {
+      const int k = n / (len.x * len.y) + lo.z;
+      const int j = (n / len.x) % len.y + lo.y;
+      const int i = n % len.x + lo.x;
+      if (useFlag && cellFlag(i, j, k) <= 0.)
+        return;
+      if (sootCellActive(
+            i, j, k, Qstate, qRhoIndx, qTempIndx, qPAHIndx, qSootIndx,
+            invMwPAH, Tcutoff, Xcutoff))
+        activePtr[s] = n;
+    },
+    Scan::Type::exclusive, Scan::retSum);
+  if (m_sootVerbosity && ParallelDescriptor::IOProcessor()) {
+    Print() << "SootModel::addSootSourceTerm(): Adding soot source term to "
+            << nactive << " of " << npts << " cells in " << vbox << std::endl;
+  }
+  if (nactive == 0)
+    return;
 
   const SootData* sd = d_sootData;
   const SootReaction* sr = d_sootReact;
-  amrex::ParallelFor(vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    auto eos = pele::physics::PhysicsType::eos();
-    SootConst sc;
-    GpuArray<Real, NUM_SPECIES> mw_fluidF;
-    GpuArray<Real, NUM_SOOT_GS> mw_fluid;
-    eos.molecular_weight(mw_fluidF.data());
-    GpuArray<Real, NUM_SPECIES> Hi;
-    GpuArray<Real, NUM_SOOT_GS> omega_src;
-    GpuArray<Real, NUM_SPECIES> rho_YF;
-    // Molar concentrations (mol/cm^3)
-    GpuArray<Real, NUM_SOOT_GS> xi_n;
-    // Array of moment values M_xy (cm^(3(x + 2/3y))cm^(-3))
-    // M00, M10, M01,..., N0
-    GpuArray<Real, NUM_SOOT_MOMENTS + 1> moments;
-    Real* momentsPtr = moments.data();
-    /*
-      These are the values inside the terms in fracMom
-      momFV[NUM_SOOT_MOMENTS] - Weight of the delta function
-      momFV[NUM_SOOT_MOMENTS+1] - modeCoef
-      where modeCoef signifies the number of modes to be used
-      If the moments are effectively zero, modeCoef = 0 and only 1 mode is used
-      Otherwise, modeCoef = 1 and both modes are used
-      The rest of the momFV values are used in fracMom fact1 = momFV[0],
-      fact2 = momFV[1]^volOrd, fact2 = momFV[2]^surfOrd, etc.
-    */
-    GpuArray<Real, NUM_SOOT_MOMENTS + 2> mom_fv;
-    Real* mom_fvPtr = mom_fv.data();
-    // Array of source terms for moment equations
-    GpuArray<Real, NUM_SOOT_MOMENTS + 1> mom_src;
-    Real* mom_srcPtr = mom_src.data();
-    Real rho = Qstate(i, j, k, qRhoIndx) * sc.rho_conv;
-    const Real T = Qstate(i, j, k, qTempIndx);
-    // Dynamic viscosity
-    const Real mu = coeff_mu(i, j, k) * sc.mu_conv;
-    // Compute species enthalpy
-    eos.T2Hi(T, Hi.data());
-    // Extract mass fractions for gas phases corresponding to GasSpecIndx
-    for (int sp = 0; sp < NUM_SPECIES; ++sp) {
-      const int peleIndx = qSpecIndx + sp;
-      // State provided by PeleLM is the concentration, rhoY
-#ifdef SOOT_PELE_LM
-      rho_YF[sp] = amrex::max(0., Qstate(i, j, k, peleIndx) * sc.rho_conv);
-#else
-      rho_YF[sp] = amrex::max(0., rho * Qstate(i, j, k, peleIndx));
-#endif
-    }
-    // Compute the average molar mass (g/mol)
-    Real molarMass = 0.;
-    for (int sp = 0; sp < NUM_SPECIES; ++sp) {
-      molarMass += rho_YF[sp] / mw_fluidF[sp];
-    }
-    molarMass = rho / molarMass;
-    // Extract moment values
-    for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom) {
-      const int peleIndx = qSootIndx + mom;
-      moments[mom] = Qstate(i, j, k, peleIndx);
-      mom_src[mom] = 0.;
-    }
-    for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-      const int spcc = sd->refIndx[sp];
-      mw_fluid[sp] = mw_fluidF[spcc];
-      xi_n[sp] = rho_YF[spcc] / mw_fluid[sp];
-      // Reset the reaction source term
-      omega_src[sp] = 0.;
+  constexpr int nm = NUM_SOOT_MOMENTS + 1;
+  // Results of the Rosenbrock integration of each active cell, the gas
+  // species concentrations, the change of the moments and the gas species
+  // sources at the start. It runs as its own kernel so the Jacobian storage
+  // does not add to the explicit kernel
+  constexpr int rosNComp = 2 * NUM_SOOT_GS + nm;
+  Gpu::DeviceVector<Real> rosData;
+  Gpu::DeviceVector<int> rosFailed;
+  const Real* rosPtr = nullptr;
+  const int* rosFailPtr = nullptr;
+  if (useRosenbrock) {
+    rosData.resize(static_cast<Long>(nactive) * rosNComp);
+    rosFailed.resize(nactive);
+    Real* rosOut = rosData.data();
+    int* rosFailOut = rosFailed.data();
+    ReduceOps<ReduceOpSum> ros_op;
+    ReduceData<int> ros_data(ros_op);
+    using RosTuple = typename decltype(ros_data)::Type;
+    ros_op.eval(nactive, ros_data, [=] AMREX_GPU_DEVICE(int n) -> RosTuple {
+      const int cell = activePtr[n];
+      const int k = cell / (len.x * len.y) + lo.z;
+      const int j = (cell / len.x) % len.y + lo.y;
+      const int i = cell % len.x + lo.x;
+      SootCellInit ci;
+      readSootCell(
+        i, j, k, Qstate, coeff_mu, sd, qRhoIndx, qTempIndx, qSpecIndx,
+        qSootIndx, ci);
+      GpuArray<Real, NUM_SOOT_REACT> k_fwd;
+      GpuArray<Real, NUM_SOOT_REACT> k_bkwd;
+      const SootCellConst cc =
+        sootCellConst(ci, sr, betaNF, k_fwd.data(), k_bkwd.data());
+      Real* out = rosOut + static_cast<Long>(n) * rosNComp;
+      Real* xi_n = out;
+      Real* mom_inc = out + NUM_SOOT_GS;
+      Real* omega_init = out + NUM_SOOT_GS + nm;
+      for (int sp = 0; sp < NUM_SOOT_GS; ++sp)
+        xi_n[sp] = ci.xi_n[sp];
+      // Adaptive implicit steps over the whole time step
+      const bool ok = sootRosenbrock(
+        sd, sr, cc, rosParams, ci.rho0, sd->mwGS.data(), dt,
+        dt / Real(nsub_init), ci.moments.data(), xi_n, mom_inc, omega_init);
+      rosFailOut[n] = ok ? 0 : 1;
+      return {ok ? 0 : 1};
+    });
+    // Number of cells where the Rosenbrock integration ran out of steps
+    const int nfailed = amrex::get<0>(ros_data.value());
+    if (nfailed > 0) {
+      Warning(
+        "SootModel::addSootSourceTerm(): Rosenbrock integration exceeded "
+        "soot.rosenbrock_max_steps in " +
+        std::to_string(nfailed) + " cells, used explicit subcycles instead");
     }
-    // Convert moments from CGS to mol of C
-    sd->convertToMol(momentsPtr);
-    // Compute constant values used throughout
-    // (R*T*Pi/(2*A*rho_soot))^(1/2)
-    const Real convT = std::sqrt(sc.colFact * T);
-    // Constant for free molecular collisions
-    const Real colConst =
-      convT * sc.colFactPi23 * sc.colFact16 * pele::physics::Constants::Avna;
-    // Collision frequency between two dimer in the free
-    // molecular regime with van der Waals enhancement
-    // Units: cm^3/mol-s
-    Real RT = pele::physics::Constants::RU * T;
-    const Real betaNucl = convT * betaNF;
-    int nsub = nsub_init;
-    Real sootdt = dt / Real(nsub);
-    int isub = 1;
-    // Subcycling
-    while (isub <= nsub && T > Tcutoff) {
-      // Clip moments
-      sd->clipMoments(momentsPtr);
-      // Molar concentration of the PAH inception species
-      Real xi_PAH = xi_n[SootGasSpecIndx::indxPAH];
-      // Compute the vector of factors used for moment interpolation
-      sd->computeFracMomVect(momentsPtr, mom_fvPtr);
-      // Compute the dimerization rate
-      const Real dimerRate = sr->dimerRate(T, xi_PAH);
-      // Estimate [DIMER]
-      Real dimerConc = sd->dimerization(convT, betaNucl, dimerRate, mom_fvPtr);
-      // Add the nucleation source term to mom_src
-      sd->nucleationMomSrc(betaNucl, dimerConc, mom_srcPtr);
-      // Add the condensation source term to mom_src
-      sd->condensationMomSrc(colConst, dimerConc, mom_fvPtr, mom_srcPtr);
-      // Add the coagulation source term to mom_src
-      sd->coagulationMomSrc(
-        colConst, T, mu, rho, molarMass, mom_fvPtr, mom_srcPtr);
-      Real surf = sc.S0 * sd->fracMom(0., 1., mom_fvPtr);
-      // Reaction rates for surface growth (k_sg), oxidation (k_ox),
-      // and fragmentation (k_o2)
-      Real k_sg = 0.;
-      Real k_ox = 0.;
-      Real k_o2 = 0.;
-      // Compute the species reaction source terms into omega_src
-      sr->chemicalSrc(
-        T, surf, xi_n.data(), momentsPtr, k_sg, k_ox, k_o2, omega_src.data());
-      if (moments[1] * sc.V0 * pele::physics::Constants::Avna > 1.E-12) {
-        // Add the surface growth source to mom_src
-        sd->surfaceGrowthMomSrc(k_sg, mom_fvPtr, mom_srcPtr);
-        sd->oxidFragMomSrc(k_ox, k_o2, mom_fvPtr, mom_srcPtr);
-      }
-      if (isub == 1) {
-        // Increase subcycles to prevent negative concentrations
+    rosPtr = rosData.data();
+    rosFailPtr = rosFailed.data();
+  }
+  ReduceOps<ReduceOpMin> reduce_op;
+  ReduceData<Real> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+  reduce_op.eval(
+    nactive, reduce_data, [=] AMREX_GPU_DEVICE(int n) -> ReduceTuple {
+      const int cell = activePtr[n];
+      const int k = cell / (len.x * len.y) + lo.z;
+      const int j = (cell / len.x) % len.y + lo.y;
+      const int i = cell % len.x + lo.x;
+      constexpr SootConst sc{};
+      // Only the soot gas species are kept per cell, the mechanism sized
+      // data is read from SootData or evaluated in a short scope
+      const Real* mw_fluid = sd->mwGS.data();
+      GpuArray<Real, NUM_SOOT_GS> omega_src;
+      SootCellInit ci;
+      readSootCell(
+        i, j, k, Qstate, coeff_mu, sd, qRhoIndx, qTempIndx, qSpecIndx,
+        qSootIndx, ci);
+      const Real rho0 = ci.rho0;
+      Real rho = rho0;
+      const Real T = ci.T;
+      const Real* rho_Y = ci.rho_Y.data();
+      Real* xi_n = ci.xi_n.data();
+      Real* momentsPtr = ci.moments.data();
+      // Fractional moments of all orders used by the source terms
+      SootFracMomCache fm_cache;
+      // Array of source terms for moment equations
+      GpuArray<Real, nm> mom_src;
+      Real* mom_srcPtr = mom_src.data();
+      // Change of the moments over dt, written to soot_state once
+      GpuArray<Real, nm> mom_inc;
+      // Gas species sources at the start for the time step estimate
+      GpuArray<Real, NUM_SOOT_GS> omega_init;
+      bool doSubcycles = true;
+      if (useRosenbrock && rosFailPtr[n] == 0) {
+        const Real* out = rosPtr + static_cast<Long>(n) * rosNComp;
         for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-          if (xi_n[sp] > Xcutoff) {
-            nsub = amrex::max(nsub, int(-dt * omega_src[sp] / xi_n[sp]) + 1);
+          xi_n[sp] = out[sp];
+          omega_init[sp] = out[NUM_SOOT_GS + nm + sp];
+        }
+        for (int mom = 0; mom < nm; ++mom)
+          mom_inc[mom] = out[NUM_SOOT_GS + mom];
+        doSubcycles = false;
+      } else {
+        // Explicit subcycles, also used where the Rosenbrock steps run out
+        for (int mom = 0; mom < nm; ++mom)
+          mom_inc[mom] = 0.;
+      }
+      if (doSubcycles) {
+        GpuArray<Real, NUM_SOOT_REACT> k_fwd;
+        GpuArray<Real, NUM_SOOT_REACT> k_bkwd;
+        const SootCellConst cc =
+          sootCellConst(ci, sr, betaNF, k_fwd.data(), k_bkwd.data());
+        int nsub = nsub_init;
+        Real sootdt = dt / Real(nsub);
+        int isub = 1;
+        // Subcycling
+        while (isub <= nsub) {
+          // Clip moments
+          sd->clipMoments(momentsPtr);
+          // Compute the moment and species source terms
+          sootSourceTerms(
+            sd, sr, cc, rho, momentsPtr, xi_n, fm_cache, mom_srcPtr,
+            omega_src.data());
+          if (isub == 1) {
+            // Increase subcycles to prevent negative concentrations
+            for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+              omega_init[sp] = omega_src[sp];
+              if (xi_n[sp] > Xcutoff) {
+                nsub =
+                  amrex::max(nsub, int(-dt * omega_src[sp] / xi_n[sp]) + 1);
+              }
+            }
+            sootdt = dt / Real(nsub);
           }
+          // Update species concentrations within subcycle
+          for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+            xi_n[sp] += sootdt * omega_src[sp];
+            rho += sootdt * omega_src[sp] * mw_fluid[sp];
+          }
+          // Update moments within subcycle
+          for (int mom = 0; mom < nm; ++mom) {
+            momentsPtr[mom] += sootdt * mom_src[mom];
+            mom_inc[mom] += sootdt * mom_src[mom];
+          }
+          isub++;
         }
-        sootdt = dt / Real(nsub);
       }
-      // Update species concentrations within subcycle
+      for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom) {
+        const int peleIndx = sootIndx + mom;
+        soot_state(i, j, k, peleIndx) += mom_inc[mom] * sd->unitConv[mom] / dt;
+      }
+      Real RT = pele::physics::Constants::RU * T;
+      // Species enthalpy, PelePhysics only evaluates all species together
+      GpuArray<Real, NUM_SOOT_GS> Hgs;
+      {
+        auto eos = pele::physics::PhysicsType::eos();
+        GpuArray<Real, NUM_SPECIES> Hi;
+        eos.T2Hi(T, Hi.data());
+        for (int sp = 0; sp < NUM_SOOT_GS; ++sp)
+          Hgs[sp] = Hi[sd->refIndx[sp]];
+      }
+      Real rho_src = 0.;
+      Real eng_src = 0.;
       for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-        const int spcc = sd->refIndx[sp];
-        const int peleIndx = specIndx + spcc;
-        xi_n[sp] += sootdt * omega_src[sp];
-        rho += sootdt * omega_src[sp] * mw_fluid[sp];
-        omega_src[sp] = 0.; // Reset omega source
+        Real newrhoY = xi_n[sp] * mw_fluid[sp];
+        // Reuse omega_src for the mass sources
+        omega_src[sp] = (newrhoY - rho_Y[sp]) / dt;
+        rho_src += omega_src[sp];
+        eng_src += omega_src[sp] * (Hgs[sp] - RT / mw_fluid[sp]);
+      }
+      if (conserveMass) {
+        // Difference between mass lost from fluid and mass gained to soot
+        Real diff_vol = soot_state(i, j, k, sootIndx + 1) * sd->unitConv[1];
+        Real del_rho_dot = rho_src + diff_vol * sc.SootDensity;
+        // Add that mass to H2
+        omega_src[absorbIndx] -= del_rho_dot;
+        rho_src -= del_rho_dot;
+        eng_src -= del_rho_dot * (Hgs[absorbIndx] - RT / mw_fluid[absorbIndx]);
       }
-      // Update moments within subcycle
+      for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+        // Convert from local gas species index to global gas species index
+        const int peleIndx = specIndx + sd->refIndx[sp];
+        soot_state(i, j, k, peleIndx) += omega_src[sp] * sc.mass_src_conv;
+      }
+      // Add density source term
+      soot_state(i, j, k, rhoIndx) += rho_src * sc.mass_src_conv;
+      soot_state(i, j, k, engIndx) += eng_src * sc.eng_src_conv;
+      if (!estimateDt)
+        return {std::numeric_limits<Real>::max()};
+      return {
+        sootStableDt(rho0, rho_Y, mw_fluid, omega_init.data(), maxDtRate)};
+    });
+  // Waits for the kernel, so the active cell list and the Rosenbrock
+  // results stay allocated until then
+  ReduceTuple hv = reduce_data.value();
+  if (estimateDt)
+    *soot_dt = amrex::min(*soot_dt, amrex::get<0>(hv));
+}
+
+#ifdef SOOT_PELE_LM
+// Add the soot source term within an SDC iteration, reusing the source of
+// an earlier iteration in cells where the state has changed less than
+// soot.sdc_lag_tol since that source was computed
+void
+SootModel::addSootSourceTermSDC(
+  const Box& vbox,
+  Array4<const Real> const& Qstate,
+  Array4<const Real> const& coeff_mu,
+  Array4<Real> const& soot_state,
+  Array4<Real> const& lag_state,
+  Array4<Real> const& lag_src,
+  const bool first_iter,
+  const Real time,
+  const Real dt) const
+{
+  BL_PROFILE("SootModel::addSootSourceTermSDC");
+  amrex::ignore_unused(time);
+  const int qRhoIndx = m_sootIndx.qRhoIndx;
+  const int qTempIndx = m_sootIndx.qTempIndx;
+  const int qSpecIndx = m_sootIndx.qSpecIndx;
+  const int qSootIndx = m_sootIndx.qSootIndx;
+  const int rhoIndx = m_sootIndx.rhoIndx;
+  const int engIndx = m_sootIndx.engIndx;
+  const int specIndx = m_sootIndx.specIndx;
+  const int sootIndx = m_sootIndx.sootIndx;
+  const Real tol = m_sdcLagTol;
+  const bool refreshAll = first_iter || tol <= 0.;
+  // Components of lag_state, the refresh flag followed by the state the
+  // stored source was computed from
+  const int lagT = 1;
+  const int lagRho = 2;
+  const int lagSoot = 3;
+  const int lagSpec = lagSoot + NUM_SOOT_MOMENTS + 1;
+  AMREX_ASSERT(lagSpec + NUM_SOOT_GS == sdcLagNComp);
+  const SootData* sd = d_sootData;
+  // Flag the cells whose state has moved away from the reference state,
+  // then clear their stored source and update the reference
+  amrex::ParallelFor(vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    bool refresh = refreshAll;
+    if (!refresh) {
+      const auto changed = [=](const Real q, const Real qref) {
+        return std::abs(q - qref) > tol * std::abs(qref);
+      };
+      refresh |= changed(Qstate(i, j, k, qTempIndx), lag_state(i, j, k, lagT));
+      refresh |= changed(Qstate(i, j, k, qRhoIndx), lag_state(i, j, k, lagRho));
       for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom) {
-        const int peleIndx = sootIndx + mom;
-        moments[mom] += sootdt * mom_src[mom];
-        soot_state(i, j, k, peleIndx) +=
-          mom_src[mom] * sd->unitConv[mom] / Real(nsub);
-        mom_src[mom] = 0.; // Reset moment source
+        refresh |= changed(
+          Qstate(i, j, k, qSootIndx + mom), lag_state(i, j, k, lagSoot + mom));
       }
-      isub++;
+      for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+        const int qIndx = qSpecIndx + sd->refIndx[sp];
+        refresh |=
+          changed(Qstate(i, j, k, qIndx), lag_state(i, j, k, lagSpec + sp));
+      }
+    }
+    lag_state(i, j, k, 0) = refresh ? 1. : 0.;
+    if (!refresh)
+      return;
+    lag_state(i, j, k, lagT) = Qstate(i, j, k, qTempIndx);
+    lag_state(i, j, k, lagRho) = Qstate(i, j, k, qRhoIndx);
+    for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom) {
+      lag_state(i, j, k, lagSoot + mom) = Qstate(i, j, k, qSootIndx + mom);
+      lag_src(i, j, k, sootIndx + mom) = 0.;
     }
-    Real rho_src = 0.;
-    Real eng_src = 0.;
     for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-      // Convert from local gas species index to global gas species index
       const int spcc = sd->refIndx[sp];
-      const int peleIndx = specIndx + spcc;
-      Real newrhoY = xi_n[sp] * mw_fluid[sp];
-      Real omegai = (newrhoY - rho_YF[spcc]) / dt;
-      soot_state(i, j, k, peleIndx) += omegai * sc.mass_src_conv;
-      rho_src += omegai;
-      eng_src += omegai * (Hi[spcc] - RT / mw_fluid[sp]);
+      lag_state(i, j, k, lagSpec + sp) = Qstate(i, j, k, qSpecIndx + spcc);
+      lag_src(i, j, k, specIndx + spcc) = 0.;
     }
-    if (conserveMass) {
-      // Difference between mass lost from fluid and mass gained to soot
-      Real diff_vol = soot_state(i, j, k, sootIndx + 1) * sd->unitConv[1];
-      Real del_rho_dot = rho_src + diff_vol * sc.SootDensity;
-      // Add that mass to H2
-      soot_state(i, j, k, absorbIndxP) -= del_rho_dot * sc.mass_src_conv;
-      rho_src -= del_rho_dot;
-      eng_src -= del_rho_dot * (Hi[absorbIndxN] - RT / mw_fluidF[absorbIndxN]);
+    lag_src(i, j, k, rhoIndx) = 0.;
+    lag_src(i, j, k, engIndx) = 0.;
+  });
+  // Compute the source of the flagged cells into the stored source
+  addSootSourceCells(vbox, Qstate, coeff_mu, lag_src, lag_state, dt, nullptr);
+  // Add the stored source of every cell
+  amrex::ParallelFor(vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    for (int mom = 0; mom < NUM_SOOT_MOMENTS + 1; ++mom)
+      soot_state(i, j, k, sootIndx + mom) += lag_src(i, j, k, sootIndx + mom);
+    for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+      const int peleIndx = specIndx + sd->refIndx[sp];
+      soot_state(i, j, k, peleIndx) += lag_src(i, j, k, peleIndx);
     }
-    // Add density source term
-    soot_state(i, j, k, rhoIndx) += rho_src * sc.mass_src_conv;
-    soot_state(i, j, k, engIndx) += eng_src * sc.eng_src_conv;
+    soot_state(i, j, k, rhoIndx) += lag_src(i, j, k, rhoIndx);
+    soot_state(i, j, k, engIndx) += lag_src(i, j, k, engIndx);
   });
 }
+#endif
 
 // Compute time step estimate for soot
 Real
@@ -517,11 +915,8 @@ SootModel::estSootDt(const Box& vbox, Array4<const Real> const& Qstate) const
   reduce_op.eval(
     vbox, reduce_data,
     [=] AMREX_GPU_DEVICE(int i, int j, int k) -> ReduceTuple {
-      auto eos = pele::physics::PhysicsType::eos();
-      SootConst sc;
-      GpuArray<Real, NUM_SPECIES> mw_fluidF;
-      GpuArray<Real, NUM_SOOT_GS> mw_fluid;
-      eos.molecular_weight(mw_fluidF.data());
+      constexpr SootConst sc{};
+      const Real* mw_fluid = sd->mwGS.data();
       GpuArray<Real, NUM_SOOT_GS> omega_src;
       GpuArray<Real, NUM_SOOT_GS> rho_Y;
       GpuArray<Real, NUM_SOOT_GS> xi_n;
@@ -543,7 +938,6 @@ SootModel::estSootDt(const Box& vbox, Array4<const Real> const& Qstate) const
 #else
         rho_Y[sp] = rho * Qstate(i, j, k, peleIndx);
 #endif
-        mw_fluid[sp] = mw_fluidF[spcc];
         xi_n[sp] = rho_Y[sp] / mw_fluid[sp];
         omega_src[sp] = 0.;
       }
@@ -556,22 +950,8 @@ SootModel::estSootDt(const Box& vbox, Array4<const Real> const& Qstate) const
       // Compute the species reaction source terms into omega_src
       sr->chemicalSrc(
         T, surf, xi_n.data(), momentsPtr, k_sg, k_ox, k_o2, omega_src.data());
-      Real rho_src = 0.;
-      for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-        rho_src += omega_src[sp] * mw_fluid[sp];
-      }
-      Real maxrate = 0.;
-      for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
-        Real Y_n = rho_Y[sp] / rho;
-        Real omegai = omega_src[sp] * mw_fluid[sp];
-        Real newrate =
-          (std::abs(omegai - Y_n * rho_src) - maxDtRate * rho_src) /
-          (maxDtRate * rho);
-        if (newrate > maxrate) {
-          maxrate = newrate;
-        }
-      }
-      return 1. / (maxrate + 1.E-12);
+      return sootStableDt(
+        rho, rho_Y.data(), mw_fluid, omega_src.data(), maxDtRate);
     });
   ReduceTuple hv = reduce_data.value();
   Real ldt_cpu = amrex::get<0>(hv);
@@ -17,7 +17,7 @@ soot_largeparticledata(
   const int* bcrec,
   const int level)
 {
-  SootConst sc;
+  constexpr SootConst sc{};
   const Real sootRho = sc.SootDensity / sc.rho_conv;
   const Real V0 = sc.V0 / std::pow(sc.len_conv, 3);
   const Real S0 = sc.S0 / std::pow(sc.len_conv, 2);
@@ -50,7 +50,7 @@ soot_genvars(
   const int* bcrec,
   const int level)
 {
-  SootConst sc;
+  constexpr SootConst sc{};
   const Real sootRho = sc.SootDensity / sc.rho_conv;
   auto const dat = datafab.array();
   auto sl = slfab.array(dcomp);
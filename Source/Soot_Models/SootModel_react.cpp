@@ -1,5 +1,6 @@
 
 // AMReX include statements
+#include <AMReX_ParmParse.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Print.H>
 #include <AMReX_Vector.H>
@@ -15,7 +16,7 @@ using namespace amrex;
 void
 SootModel::initializeReactData()
 {
-  SootConst sc;
+  constexpr SootConst sc{};
   m_sootReact->SootDensityC = sc.SootDensityC;
   m_sootReact->SootChi = sc.SootChi;
   // Be sure that all other member data has been filled
@@ -150,5 +151,96 @@ SootModel::initializeReactData()
   m_sootReact->nu_f[6 * 3 + 0] = 2.;
   m_sootReact->sIndx_f[6] = -1; // No soot in reactants
 
+  // Replace the rates and gas species of the reactions given in the inputs
+  readSurfaceMech();
+  m_sootReact->setRateTypes();
   m_reactDataFilled = true;
 }
+
+// Read surface reactions that replace the default HACA mechanism
+// The reactions keep their role in the mechanism, so a variant lists the
+// reactions it changes as, for example
+// soot.reaction_4.forward = 2.52E9 1.10 17.13  # A (CGS), n, E (kJ/mol)
+// soot.reaction_4.reactants = C2H2
+// soot.reaction_4.reactant_coeffs = 1.
+// A full mechanism can be kept in a separate file and included in the
+// inputs with FILE = <file>
+void
+SootModel::readSurfaceMech()
+{
+  // The dimerization rate is defined by the PAH sticking coefficient
+  const int numRead = NUM_SOOT_REACT - 1;
+  // Convert activation energies from kJ/mol to erg/mol
+  const Real Econv = 1.E10;
+  for (int r = 0; r < numRead; ++r) {
+    const std::string rname = "soot.reaction_" + std::to_string(r + 1);
+    ParmParse pp(rname);
+    bool changed = false;
+    for (int dir = 0; dir < 2; ++dir) {
+      const std::string rateName = (dir == 0) ? "forward" : "reverse";
+      if (!pp.contains(rateName.c_str()))
+        continue;
+      Vector<Real> rate;
+      pp.getarr(rateName.c_str(), rate);
+      if (rate.size() != 3)
+        Abort(rname + "." + rateName + " must be A n E");
+      const Real ER = rate[2] * Econv / pele::physics::Constants::RU;
+      if (dir == 0) {
+        m_sootReact->A_f[r] = rate[0];
+        m_sootReact->n_f[r] = rate[1];
+        m_sootReact->ER_f[r] = ER;
+      } else {
+        m_sootReact->A_b[r] = rate[0];
+        m_sootReact->n_b[r] = rate[1];
+        m_sootReact->ER_b[r] = ER;
+      }
+      changed = true;
+    }
+    for (int dir = 0; dir < 2; ++dir) {
+      const std::string specName = (dir == 0) ? "reactants" : "products";
+      const std::string coeffName =
+        (dir == 0) ? "reactant_coeffs" : "product_coeffs";
+      if (!pp.contains(specName.c_str()))
+        continue;
+      Vector<std::string> specs;
+      pp.getarr(specName.c_str(), specs);
+      const int nspec = static_cast<int>(specs.size());
+      if (nspec > 3)
+        Abort(rname + "." + specName + " can have at most 3 species");
+      Vector<Real> coeffs(specs.size(), 1.);
+      pp.queryarr(coeffName.c_str(), coeffs);
+      if (coeffs.size() != specs.size())
+        Abort(rname + "." + coeffName + " must match " + specName);
+      int* nIndx = (dir == 0) ? m_sootReact->nIndx_f.data()
+                              : m_sootReact->nIndx_b.data();
+      Real* nu =
+        (dir == 0) ? m_sootReact->nu_f.data() : m_sootReact->nu_b.data();
+      for (int j = 0; j < 3; ++j) {
+        nIndx[3 * r + j] = 0;
+        nu[3 * r + j] = 0.;
+      }
+      for (int j = 0; j < nspec; ++j) {
+        const std::string& spec = (specs[j] == "PAH") ? m_PAHname : specs[j];
+        int indx = -1;
+        for (int sp = 0; sp < NUM_SOOT_GS; ++sp) {
+          if (m_gasSpecNames[sp] == spec)
+            indx = sp;
+        }
+        if (indx < 0)
+          Abort(rname + ": " + specs[j] + " is not a soot gas species");
+        nIndx[3 * r + j] = indx;
+        nu[3 * r + j] = coeffs[j];
+      }
+      if (dir == 0) {
+        m_sootReact->rNum[r] = nspec;
+      } else {
+        m_sootReact->pNum[r] = nspec;
+      }
+      changed = true;
+    }
+    if (changed && m_sootVerbosity) {
+      Print() << "SootModel::readSurfaceMech(): Reaction " << r + 1
+              << " read from " << rname << std::endl;
+    }
+  }
+}